@@ -0,0 +1,59 @@
+#ifndef ALLPAIRSSHORTESTPATHS_H
+#define ALLPAIRSSHORTESTPATHS_H
+
+#include <QVector>
+#include <QtGlobal>
+
+class Graph;
+class GraphSnapshot;
+
+/**
+ * @brief All-pairs shortest paths over the graph snapshot, kept until the
+ *        graph changes
+ *
+ * Distances and first hops live in flat row-major n x n arrays indexed by
+ * snapshot index. Two strategies fill them; they add edge weights in a
+ * different order, so distances agree only up to rounding:
+ *
+ * - Floyd-Warshall runs in square tiles: for every diagonal tile the tile
+ *   itself is relaxed first, then its row and column of tiles in parallel,
+ *   then all remaining tiles in parallel. Best for dense graphs.
+ * - One Dijkstra per source row, spread over the workers, each of which
+ *   keeps its own heap and visited buffer. Best for sparse graphs.
+ *
+ * Automatic picks Dijkstra unless the graph is dense enough that the
+ * vectorised Floyd-Warshall kernel wins.
+ */
+class AllPairsShortestPaths {
+public:
+    enum Method { Automatic, FloydWarshall, Dijkstra };
+    
+    AllPairsShortestPaths();
+    
+    bool isCurrent(const Graph& graph) const;
+    void compute(const Graph& graph, Method method = Automatic);
+    void clear();
+    
+    static Method chooseMethod(int nodeCount, int edgeCount);
+    Method method() const;
+    
+    int nodeCount() const;
+    bool hasPath(int fromIndex, int toIndex) const;
+    double distance(int fromIndex, int toIndex) const;
+    QVector<int> path(int fromIndex, int toIndex) const;
+    
+private:
+    int m_nodeCount;
+    QVector<double> m_dist;
+    QVector<int> m_next;
+    Method m_method;
+    bool m_valid;
+    quint64 m_structureVersion;
+    quint64 m_closureVersion;
+    
+    void computeFloydWarshall(const GraphSnapshot& snapshot);
+    void computeDijkstra(const GraphSnapshot& snapshot);
+    void relaxTile(int rowBlock, int columnBlock, int pivotBlock);
+};
+
+#endif // ALLPAIRSSHORTESTPATHS_H
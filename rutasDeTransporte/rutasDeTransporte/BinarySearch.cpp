@@ -2,8 +2,10 @@
 #include <QFile>
 #include <QTextStream>
 #include <QStringConverter>
+#include <algorithm>
 
-BinarySearchTree::BinarySearchTree() : m_root(nullptr), m_size(0) {}
+BinarySearchTree::BinarySearchTree(BalanceMode mode) 
+    : m_root(nullptr), m_size(0), m_mode(mode) {}
 
 BinarySearchTree::~BinarySearchTree() { clear(); }
 
@@ -20,12 +22,50 @@ TreeNode* BinarySearchTree::insertRecursive(TreeNode* node, const Station& stati
         node->left = insertRecursive(node->left, station);
     } else if (station > node->data) {
         node->right = insertRecursive(node->right, station);
+    } else {
+        return node;
     }
+    return rebalance(node);
+}
+
+void BinarySearchTree::bulkLoad(const QVector<Station>& stations) {
+    // Sorted input (the usual case for estaciones.txt) skips the sort entirely
+    QVector<Station> incoming = stations;
+    if (!std::is_sorted(incoming.begin(), incoming.end())) {
+        std::stable_sort(incoming.begin(), incoming.end());
+    }
+    
+    // Keep the first occurrence of each ID, like repeated insert() calls would
+    QVector<Station> existing = getAllStations();
+    QVector<Station> merged;
+    merged.reserve(existing.size() + incoming.size());
+    int i = 0;
+    int j = 0;
+    while (i < existing.size() || j < incoming.size()) {
+        const Station& next = (j >= incoming.size() || (i < existing.size() && !(incoming[j] < existing[i])))
+                              ? existing[i++] : incoming[j++];
+        if (merged.isEmpty() || merged.last() < next) {
+            merged.append(next);
+        }
+    }
+    
+    clear();
+    m_root = buildBalanced(merged, 0, merged.size());
+    m_size = merged.size();
+}
+
+TreeNode* BinarySearchTree::buildBalanced(const QVector<Station>& sorted, int begin, int end) {
+    if (begin >= end) return nullptr;
+    int middle = begin + (end - begin) / 2;
+    TreeNode* node = new TreeNode(sorted[middle]);
+    node->left = buildBalanced(sorted, begin, middle);
+    node->right = buildBalanced(sorted, middle + 1, end);
+    updateHeight(node);
     return node;
 }
 
 bool BinarySearchTree::search(int id, Station& result) const {
-    TreeNode* found = searchRecursive(m_root, id);
+    TreeNode* found = searchNode(id);
     if (found) {
         result = found->data;
         return true;
@@ -33,10 +73,12 @@ bool BinarySearchTree::search(int id, Station& result) const {
     return false;
 }
 
-TreeNode* BinarySearchTree::searchRecursive(TreeNode* node, int id) const {
-    if (node == nullptr || node->data.getId() == id) return node;
-    if (id < node->data.getId()) return searchRecursive(node->left, id);
-    return searchRecursive(node->right, id);
+TreeNode* BinarySearchTree::searchNode(int id) const {
+    TreeNode* node = m_root;
+    while (node != nullptr && node->data.getId() != id) {
+        node = (id < node->data.getId()) ? node->left : node->right;
+    }
+    return node;
 }
 
 bool BinarySearchTree::remove(int id) {
@@ -70,7 +112,7 @@ TreeNode* BinarySearchTree::removeRecursive(TreeNode* node, int id, bool& succes
         node->data = minRight->data;
         node->right = removeRecursive(node->right, minRight->data.getId(), success);
     }
-    return node;
+    return rebalance(node);
 }
 
 TreeNode* BinarySearchTree::findMin(TreeNode* node) const {
@@ -79,17 +121,72 @@ TreeNode* BinarySearchTree::findMin(TreeNode* node) const {
 }
 
 void BinarySearchTree::clear() {
-    clearRecursive(m_root);
+    clearNodes(m_root);
     m_root = nullptr;
     m_size = 0;
 }
 
-void BinarySearchTree::clearRecursive(TreeNode* node) {
-    if (node != nullptr) {
-        clearRecursive(node->left);
-        clearRecursive(node->right);
-        delete node;
+void BinarySearchTree::clearNodes(TreeNode* node) {
+    // Rotate left children up so the tree unrolls into a chain that can be
+    // deleted without recursion, whatever its shape
+    while (node != nullptr) {
+        if (node->left != nullptr) {
+            TreeNode* left = node->left;
+            node->left = left->right;
+            left->right = node;
+            node = left;
+        } else {
+            TreeNode* right = node->right;
+            delete node;
+            node = right;
+        }
+    }
+}
+
+int BinarySearchTree::height(TreeNode* node) const {
+    return node ? node->height : 0;
+}
+
+void BinarySearchTree::updateHeight(TreeNode* node) {
+    node->height = 1 + qMax(height(node->left), height(node->right));
+}
+
+TreeNode* BinarySearchTree::rotateLeft(TreeNode* node) {
+    TreeNode* pivot = node->right;
+    node->right = pivot->left;
+    pivot->left = node;
+    updateHeight(node);
+    updateHeight(pivot);
+    return pivot;
+}
+
+TreeNode* BinarySearchTree::rotateRight(TreeNode* node) {
+    TreeNode* pivot = node->left;
+    node->left = pivot->right;
+    pivot->right = node;
+    updateHeight(node);
+    updateHeight(pivot);
+    return pivot;
+}
+
+TreeNode* BinarySearchTree::rebalance(TreeNode* node) {
+    updateHeight(node);
+    if (m_mode != BalanceMode::AVL) return node;
+    
+    int balance = height(node->left) - height(node->right);
+    if (balance > 1) {
+        if (height(node->left->left) < height(node->left->right)) {
+            node->left = rotateLeft(node->left);
+        }
+        return rotateRight(node);
+    }
+    if (balance < -1) {
+        if (height(node->right->right) < height(node->right->left)) {
+            node->right = rotateRight(node->right);
+        }
+        return rotateLeft(node);
     }
+    return node;
 }
 
 QVector<int> BinarySearchTree::inOrderTraversal() const {
@@ -187,3 +284,7 @@ bool BinarySearchTree::exportTraversals(const QString& filename) const {
 bool BinarySearchTree::isEmpty() const { return m_root == nullptr; }
 
 int BinarySearchTree::getSize() const { return m_size; }
+
+int BinarySearchTree::getHeight() const { return height(m_root); }
+
+BinarySearchTree::BalanceMode BinarySearchTree::getBalanceMode() const { return m_mode; }
@@ -8,13 +8,19 @@
 
 /**
  * @brief Binary Search Tree for storing stations
+ *
+ * In AVL mode (the default) the tree rebalances itself after every insert
+ * and remove, so sorted input no longer degenerates into a linked list.
  */
 class BinarySearchTree {
 public:
-    BinarySearchTree();
+    enum class BalanceMode { None, AVL };
+    
+    explicit BinarySearchTree(BalanceMode mode = BalanceMode::AVL);
     ~BinarySearchTree();
     
     void insert(const Station& station);
+    void bulkLoad(const QVector<Station>& stations);
     bool search(int id, Station& result) const;
     bool remove(int id);
     void clear();
@@ -27,16 +33,26 @@ public:
     bool exportTraversals(const QString& filename) const;
     bool isEmpty() const;
     int getSize() const;
+    int getHeight() const;
+    BalanceMode getBalanceMode() const;
     
 private:
     TreeNode* m_root;
     int m_size;
+    BalanceMode m_mode;
     
     TreeNode* insertRecursive(TreeNode* node, const Station& station);
-    TreeNode* searchRecursive(TreeNode* node, int id) const;
+    TreeNode* searchNode(int id) const;
     TreeNode* removeRecursive(TreeNode* node, int id, bool& success);
     TreeNode* findMin(TreeNode* node) const;
-    void clearRecursive(TreeNode* node);
+    TreeNode* buildBalanced(const QVector<Station>& sorted, int begin, int end);
+    void clearNodes(TreeNode* node);
+    
+    int height(TreeNode* node) const;
+    void updateHeight(TreeNode* node);
+    TreeNode* rotateLeft(TreeNode* node);
+    TreeNode* rotateRight(TreeNode* node);
+    TreeNode* rebalance(TreeNode* node);
     
     void inOrderRecursive(TreeNode* node, QVector<int>& result) const;
     void preOrderRecursive(TreeNode* node, QVector<int>& result) const;
@@ -0,0 +1,177 @@
+#include "BinarySnapshot.h"
+#include "Graph.h"
+#include "MappedFile.h"
+#include <QSaveFile>
+#include <QByteArray>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+const char SnapshotMagic[8] = {'R', 'U', 'T', 'A', 'S', 'N', 'A', 'P'};
+const quint32 ByteOrderMark = 0x01020304;
+
+struct SnapshotHeader {
+    char magic[8];
+    quint32 version;
+    quint32 byteOrderMark;
+    quint32 stationCount;
+    quint32 edgeCount;
+    quint64 nameBytes;
+    quint64 payloadSize;
+    quint64 checksum;
+};
+
+static_assert(sizeof(SnapshotHeader) == 48, "SnapshotHeader must stay packed");
+
+qint64 aligned(qint64 size) {
+    return (size + 7) & ~qint64(7);
+}
+
+template <typename T>
+void appendSection(QByteArray& payload, const T* data, qint64 count) {
+    payload.append(reinterpret_cast<const char*>(data), count * qint64(sizeof(T)));
+    payload.append(QByteArray(aligned(payload.size()) - payload.size(), '\0'));
+}
+
+template <typename T>
+bool readSection(const char*& cursor, const char* end, QVector<T>& out, qint64 count) {
+    qint64 bytes = count * qint64(sizeof(T));
+    if (end - cursor < bytes) return false;
+    out.resize(count);
+    if (bytes > 0) std::memcpy(out.data(), cursor, bytes);
+    cursor += aligned(bytes);
+    return true;
+}
+
+}
+
+bool BinarySnapshot::write(const QString& filename, const Graph& graph) {
+    const GraphSnapshot& snapshot = graph.getSnapshot();
+    QVector<Station> stations = graph.getAllStations();
+    int n = snapshot.nodeCount();
+    int m = snapshot.edgeCount();
+    
+    QByteArray names;
+    QVector<quint32> nameOffsets;
+    nameOffsets.reserve(n + 1);
+    for (const Station& station : stations) {
+        nameOffsets.append(static_cast<quint32>(names.size()));
+        names.append(station.getName().toUtf8());
+    }
+    nameOffsets.append(static_cast<quint32>(names.size()));
+    
+    QVector<double> coordinates;
+    coordinates.reserve(2 * n);
+    for (const Station& station : stations) {
+        coordinates.append(station.hasCoordinates() ? station.getX() : std::numeric_limits<double>::quiet_NaN());
+        coordinates.append(station.hasCoordinates() ? station.getY() : std::numeric_limits<double>::quiet_NaN());
+    }
+    
+    QByteArray payload;
+    payload.reserve(aligned(n * 4) + aligned((n + 1) * 4) + aligned(names.size()) + n * 16 +
+                    aligned((n + 1) * 4) + aligned(m * 4) + m * 8 + aligned(m));
+    appendSection(payload, snapshot.stationIds().constData(), n);
+    appendSection(payload, nameOffsets.constData(), n + 1);
+    appendSection(payload, names.constData(), names.size());
+    appendSection(payload, coordinates.constData(), 2 * n);
+    appendSection(payload, snapshot.offsets().constData(), n + 1);
+    appendSection(payload, snapshot.targets().constData(), m);
+    appendSection(payload, snapshot.weights().constData(), m);
+    appendSection(payload, snapshot.closed().constData(), m);
+    
+    SnapshotHeader header;
+    std::memcpy(header.magic, SnapshotMagic, sizeof(header.magic));
+    header.version = FormatVersion;
+    header.byteOrderMark = ByteOrderMark;
+    header.stationCount = static_cast<quint32>(n);
+    header.edgeCount = static_cast<quint32>(m);
+    header.nameBytes = static_cast<quint64>(names.size());
+    header.payloadSize = static_cast<quint64>(payload.size());
+    header.checksum = checksum(payload.constData(), payload.size());
+    
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(payload);
+    return file.commit();
+}
+
+bool BinarySnapshot::read(const QString& filename, QVector<Station>& stations, GraphSnapshot& snapshot) {
+    MappedFile file(filename);
+    if (!file.open() || file.size() < qint64(sizeof(SnapshotHeader))) return false;
+    
+    SnapshotHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, SnapshotMagic, sizeof(header.magic)) != 0 ||
+        header.version != FormatVersion || header.byteOrderMark != ByteOrderMark ||
+        header.payloadSize != quint64(file.size() - qint64(sizeof(header)))) {
+        return false;
+    }
+    
+    const char* cursor = file.data() + sizeof(header);
+    const char* end = cursor + header.payloadSize;
+    if (checksum(cursor, end - cursor) != header.checksum) return false;
+    
+    qint64 n = header.stationCount;
+    qint64 m = header.edgeCount;
+    QVector<int> stationIds;
+    QVector<quint32> nameOffsets;
+    QVector<char> names;
+    QVector<double> coordinates;
+    QVector<int> offsets;
+    QVector<int> targets;
+    QVector<double> weights;
+    QVector<char> closed;
+    
+    if (!readSection(cursor, end, stationIds, n) ||
+        !readSection(cursor, end, nameOffsets, n + 1) ||
+        !readSection(cursor, end, names, static_cast<qint64>(header.nameBytes)) ||
+        !readSection(cursor, end, coordinates, 2 * n) ||
+        !readSection(cursor, end, offsets, n + 1) ||
+        !readSection(cursor, end, targets, m) ||
+        !readSection(cursor, end, weights, m) ||
+        !readSection(cursor, end, closed, m)) {
+        return false;
+    }
+    
+    if (offsets[0] != 0 || offsets[n] != m || nameOffsets[n] != header.nameBytes) return false;
+    for (qint64 i = 0; i < n; ++i) {
+        if (offsets[i] > offsets[i + 1] || nameOffsets[i] > nameOffsets[i + 1]) return false;
+        if (i > 0 && stationIds[i - 1] >= stationIds[i]) return false;
+    }
+    for (int target : targets) {
+        if (target < 0 || target >= n) return false;
+    }
+    
+    stations.clear();
+    stations.reserve(n);
+    for (qint64 i = 0; i < n; ++i) {
+        QString name = QString::fromUtf8(names.constData() + nameOffsets[i], nameOffsets[i + 1] - nameOffsets[i]);
+        Station station(stationIds[i], name);
+        double x = coordinates[2 * i];
+        double y = coordinates[2 * i + 1];
+        if (!std::isnan(x) && !std::isnan(y)) station.setCoordinates(x, y);
+        stations.append(station);
+    }
+    
+    snapshot.assign(stationIds, offsets, targets, weights, closed);
+    return true;
+}
+
+quint64 BinarySnapshot::checksum(const char* data, qint64 size) {
+    // FNV-1a over 64-bit words, with a byte-wise tail
+    const quint64 prime = 1099511628211ULL;
+    quint64 hash = 14695981039346656037ULL;
+    qint64 i = 0;
+    for (; i + 8 <= size; i += 8) {
+        quint64 word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ static_cast<uchar>(data[i])) * prime;
+    }
+    return hash;
+}
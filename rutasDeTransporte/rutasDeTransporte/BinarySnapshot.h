@@ -0,0 +1,42 @@
+#ifndef BINARYSNAPSHOT_H
+#define BINARYSNAPSHOT_H
+
+#include "GraphSnapshot.h"
+#include "Station.h"
+#include <QString>
+#include <QVector>
+
+class Graph;
+
+/**
+ * @brief Versioned binary image of the network for fast startup
+ *
+ * Layout (little-endian, every section 8-byte aligned):
+ *   header      magic "RUTASNAP", version, counts, payload size, checksum
+ *   stationIds  qint32[stationCount], ascending
+ *   nameOffsets quint32[stationCount + 1] into the UTF-8 name table
+ *   names       UTF-8 bytes
+ *   coordinates double[2 * stationCount], x/y pairs, NaN when absent
+ *   offsets     qint32[stationCount + 1], CSR row starts
+ *   targets     qint32[edgeCount], dense station indices
+ *   weights     double[edgeCount]
+ *   closed      quint8[edgeCount]
+ *
+ * The checksum covers the whole payload after the header. The text files
+ * remain the interchange format; this file is only a cache of them.
+ *
+ * The file is mapped rather than parsed, but read() still copies every
+ * section out of the mapping and Graph::restore() rebuilds the adjacency
+ * maps and edge index from them, so loading remains linear in the number
+ * of edges. What it saves is the text tokenizing and number conversion.
+ */
+class BinarySnapshot {
+public:
+    static const quint32 FormatVersion = 2;
+    
+    static bool write(const QString& filename, const Graph& graph);
+    static bool read(const QString& filename, QVector<Station>& stations, GraphSnapshot& snapshot);
+    static quint64 checksum(const char* data, qint64 size);
+};
+
+#endif // BINARYSNAPSHOT_H
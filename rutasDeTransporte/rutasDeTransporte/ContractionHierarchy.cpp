@@ -0,0 +1,589 @@
+#include "ContractionHierarchy.h"
+#include "Graph.h"
+#include "GraphSnapshot.h"
+#include "BinarySnapshot.h"
+#include "MappedFile.h"
+#include <QSaveFile>
+#include <QByteArray>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+const char HierarchyMagic[8] = {'R', 'U', 'T', 'A', 'S', '_', 'C', 'H'};
+const quint32 ByteOrderMark = 0x01020304;
+
+// Settled-node budgets of a witness search. Running out only costs an
+// unnecessary shortcut, never a wrong distance, so the searches that merely
+// estimate a priority get a much smaller one
+const int WitnessSettleLimit = 500;
+const int SimulationSettleLimit = 20;
+
+struct HierarchyHeader {
+    char magic[8];
+    quint32 version;
+    quint32 byteOrderMark;
+    quint32 nodeCount;
+    quint32 arcCount;
+    quint64 fingerprint;
+    quint64 payloadSize;
+    quint64 checksum;
+};
+
+static_assert(sizeof(HierarchyHeader) == 48, "HierarchyHeader must stay packed");
+
+qint64 aligned(qint64 size) {
+    return (size + 7) & ~qint64(7);
+}
+
+template <typename T>
+void appendSection(QByteArray& payload, const QVector<T>& data) {
+    payload.append(reinterpret_cast<const char*>(data.constData()), data.size() * qint64(sizeof(T)));
+    payload.append(QByteArray(aligned(payload.size()) - payload.size(), '\0'));
+}
+
+template <typename T>
+bool readSection(const char*& cursor, const char* end, QVector<T>& out, qint64 count) {
+    qint64 bytes = count * qint64(sizeof(T));
+    if (end - cursor < bytes) return false;
+    out.resize(count);
+    if (bytes > 0) std::memcpy(out.data(), cursor, bytes);
+    cursor += aligned(bytes);
+    return true;
+}
+
+/**
+ * @brief Working graph of a hierarchy under construction
+ *
+ * Arcs are never edited in place: a cheaper shortcut gets a new arc and the
+ * old one is marked dead, so the children of every shortcut stay valid.
+ */
+class Contractor {
+public:
+    explicit Contractor(int nodeCount)
+        : m_out(nodeCount), m_in(nodeCount), m_contracted(nodeCount, 0),
+          m_contractedNeighbours(nodeCount, 0), m_depth(nodeCount, 0),
+          m_witnessDistance(nodeCount, std::numeric_limits<double>::infinity()),
+          m_witnessHeap(nodeCount) {}
+    
+    QVector<int> from;
+    QVector<int> to;
+    QVector<double> weight;
+    QVector<int> first;
+    QVector<int> second;
+    QVector<char> dead;
+    
+    int addArc(int arcFrom, int arcTo, double arcWeight, int arcFirst, int arcSecond) {
+        int arc = from.size();
+        from.append(arcFrom);
+        to.append(arcTo);
+        weight.append(arcWeight);
+        first.append(arcFirst);
+        second.append(arcSecond);
+        dead.append(0);
+        m_out[arcFrom].append(arc);
+        m_in[arcTo].append(arc);
+        return arc;
+    }
+    
+    double priority(int node) {
+        int removed = 0;
+        for (int arc : m_out[node]) {
+            if (!m_contracted[to[arc]]) removed++;
+        }
+        for (int arc : m_in[node]) {
+            if (!m_contracted[from[arc]]) removed++;
+        }
+        // Edge difference dominates; contracted neighbours and depth spread
+        // the contraction evenly over the network
+        int edgeDifference = contract(node, true) - removed;
+        return 2.0 * edgeDifference + m_contractedNeighbours[node] + m_depth[node];
+    }
+    
+    int contract(int node, bool simulate) {
+        QVector<int> outgoing;
+        for (int arc : m_out[node]) {
+            if (!m_contracted[to[arc]]) outgoing.append(arc);
+        }
+        
+        int shortcuts = 0;
+        for (int incoming : m_in[node]) {
+            int source = from[incoming];
+            if (m_contracted[source]) continue;
+            
+            double limit = -1.0;
+            for (int arc : outgoing) {
+                if (to[arc] != source) limit = std::max(limit, weight[incoming] + weight[arc]);
+            }
+            if (limit < 0.0) continue;
+            
+            witnessSearch(source, node, limit, simulate ? SimulationSettleLimit : WitnessSettleLimit);
+            for (int arc : outgoing) {
+                int target = to[arc];
+                double cost = weight[incoming] + weight[arc];
+                if (target == source || m_witnessDistance[target] <= cost) continue;
+                shortcuts++;
+                if (!simulate) addShortcut(source, target, cost, incoming, arc);
+            }
+            resetWitness();
+        }
+        return shortcuts;
+    }
+    
+    // Returns the remaining neighbours, whose priorities are now stale
+    QVector<int> markContracted(int node) {
+        m_contracted[node] = 1;
+        QVector<int> neighbours;
+        for (int arc : m_out[node]) {
+            if (!m_contracted[to[arc]]) neighbours.append(to[arc]);
+        }
+        for (int arc : m_in[node]) {
+            if (!m_contracted[from[arc]]) neighbours.append(from[arc]);
+        }
+        std::sort(neighbours.begin(), neighbours.end());
+        neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+        for (int neighbour : neighbours) {
+            m_depth[neighbour] = std::max(m_depth[neighbour], m_depth[node] + 1);
+            detach(neighbour);
+        }
+        return neighbours;
+    }
+    
+private:
+    QVector<QVector<int>> m_out;
+    QVector<QVector<int>> m_in;
+    QVector<char> m_contracted;
+    QVector<int> m_contractedNeighbours;
+    QVector<int> m_depth;
+    QVector<double> m_witnessDistance;
+    QVector<int> m_witnessTouched;
+    IndexedMinHeap m_witnessHeap;
+    
+    void addShortcut(int source, int target, double cost, int firstArc, int secondArc) {
+        for (int& arc : m_out[source]) {
+            if (to[arc] != target) continue;
+            if (weight[arc] <= cost) return;
+            
+            int replaced = arc;
+            dead[replaced] = 1;
+            int shortcut = from.size();
+            from.append(source);
+            to.append(target);
+            weight.append(cost);
+            first.append(firstArc);
+            second.append(secondArc);
+            dead.append(0);
+            arc = shortcut;
+            for (int& incoming : m_in[target]) {
+                if (incoming == replaced) incoming = shortcut;
+            }
+            return;
+        }
+        addArc(source, target, cost, firstArc, secondArc);
+    }
+    
+    // Drops the arcs a neighbour keeps towards contracted stations so later
+    // scans stay proportional to the remaining graph
+    void detach(int node) {
+        m_contractedNeighbours[node]++;
+        int kept = 0;
+        for (int arc : m_out[node]) {
+            if (!m_contracted[to[arc]]) m_out[node][kept++] = arc;
+        }
+        m_out[node].resize(kept);
+        kept = 0;
+        for (int arc : m_in[node]) {
+            if (!m_contracted[from[arc]]) m_in[node][kept++] = arc;
+        }
+        m_in[node].resize(kept);
+    }
+    
+    void witnessSearch(int source, int excluded, double limit, int settleLimit) {
+        m_witnessDistance[source] = 0.0;
+        m_witnessTouched.append(source);
+        m_witnessHeap.push(source, 0.0);
+        
+        int settled = 0;
+        while (!m_witnessHeap.isEmpty() && settled < settleLimit) {
+            if (m_witnessHeap.topKey() > limit) break;
+            int current = m_witnessHeap.popMin();
+            settled++;
+            
+            for (int arc : m_out[current]) {
+                int next = to[arc];
+                if (next == excluded || m_contracted[next]) continue;
+                double distance = m_witnessDistance[current] + weight[arc];
+                if (distance < m_witnessDistance[next]) {
+                    if (m_witnessDistance[next] == std::numeric_limits<double>::infinity()) {
+                        m_witnessTouched.append(next);
+                    }
+                    m_witnessDistance[next] = distance;
+                    m_witnessHeap.pushOrDecrease(next, distance);
+                }
+            }
+        }
+    }
+    
+    void resetWitness() {
+        for (int node : m_witnessTouched) {
+            m_witnessDistance[node] = std::numeric_limits<double>::infinity();
+        }
+        m_witnessTouched.clear();
+        m_witnessHeap.clear();
+    }
+};
+
+}
+
+ContractionHierarchy::ContractionHierarchy()
+    : m_nodeCount(0), m_fingerprint(0), m_valid(false), m_structureVersion(0), m_closureVersion(0) {}
+
+bool ContractionHierarchy::isCurrent(const Graph& graph) const {
+    return m_valid && m_structureVersion == graph.getStructureVersion() &&
+           m_closureVersion == graph.getClosureVersion();
+}
+
+void ContractionHierarchy::build(const Graph& graph) {
+    build(graph.getSnapshot(), graph.getStructureVersion(), graph.getClosureVersion());
+}
+
+void ContractionHierarchy::build(const GraphSnapshot& snapshot, quint64 structureVersion, quint64 closureVersion) {
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    int n = snapshot.nodeCount();
+    
+    // The graph keeps one edge per station pair, so no merging is needed
+    Contractor contractor(n);
+    for (int from = 0; from < n; ++from) {
+        for (int e = offsets[from]; e < offsets[from + 1]; ++e) {
+            if (!closed[e] && targets[e] != from) {
+                contractor.addArc(from, targets[e], weights[e], -1, -1);
+            }
+        }
+    }
+    
+    IndexedMinHeap queue(n);
+    for (int node = 0; node < n; ++node) {
+        queue.push(node, contractor.priority(node));
+    }
+    
+    // Neighbours are re-evaluated after every contraction; the lazy check
+    // catches the remaining stations whose priority grew since then
+    m_rank.fill(0, n);
+    int level = 0;
+    while (!queue.isEmpty()) {
+        int node = queue.popMin();
+        double priority = contractor.priority(node);
+        if (!queue.isEmpty() && priority > queue.topKey()) {
+            queue.push(node, priority);
+            continue;
+        }
+        contractor.contract(node, false);
+        m_rank[node] = level++;
+        for (int neighbour : contractor.markContracted(node)) {
+            queue.changeKey(neighbour, contractor.priority(neighbour));
+        }
+    }
+    
+    // Replaced arcs are never children of a live shortcut, so they can be
+    // dropped; renumbering keeps children ahead of their parents
+    QVector<int> renumbered(contractor.from.size(), -1);
+    m_arcFrom.clear();
+    m_arcTo.clear();
+    m_arcWeight.clear();
+    m_arcFirst.clear();
+    m_arcSecond.clear();
+    for (int arc = 0; arc < contractor.from.size(); ++arc) {
+        if (contractor.dead[arc]) continue;
+        renumbered[arc] = m_arcFrom.size();
+        m_arcFrom.append(contractor.from[arc]);
+        m_arcTo.append(contractor.to[arc]);
+        m_arcWeight.append(contractor.weight[arc]);
+        m_arcFirst.append(contractor.first[arc] == -1 ? -1 : renumbered[contractor.first[arc]]);
+        m_arcSecond.append(contractor.second[arc] == -1 ? -1 : renumbered[contractor.second[arc]]);
+    }
+    
+    m_nodeCount = n;
+    m_fingerprint = fingerprint(snapshot);
+    buildSearchGraph();
+    m_valid = true;
+    m_structureVersion = structureVersion;
+    m_closureVersion = closureVersion;
+}
+
+void ContractionHierarchy::clear() {
+    m_nodeCount = 0;
+    m_rank.clear();
+    m_fingerprint = 0;
+    m_arcFrom.clear();
+    m_arcTo.clear();
+    m_arcWeight.clear();
+    m_arcFirst.clear();
+    m_arcSecond.clear();
+    m_forwardOffsets.clear();
+    m_forwardArcs.clear();
+    m_backwardOffsets.clear();
+    m_backwardArcs.clear();
+    m_forwardDistance.clear();
+    m_backwardDistance.clear();
+    m_forwardParent.clear();
+    m_backwardParent.clear();
+    m_touched.clear();
+    m_forwardHeap.reset(0);
+    m_backwardHeap.reset(0);
+    m_valid = false;
+}
+
+bool ContractionHierarchy::save(const QString& filename) const {
+    if (!m_valid) return false;
+    
+    QByteArray payload;
+    appendSection(payload, m_rank);
+    appendSection(payload, m_arcFrom);
+    appendSection(payload, m_arcTo);
+    appendSection(payload, m_arcWeight);
+    appendSection(payload, m_arcFirst);
+    appendSection(payload, m_arcSecond);
+    
+    HierarchyHeader header;
+    std::memcpy(header.magic, HierarchyMagic, sizeof(header.magic));
+    header.version = FormatVersion;
+    header.byteOrderMark = ByteOrderMark;
+    header.nodeCount = static_cast<quint32>(m_nodeCount);
+    header.arcCount = static_cast<quint32>(m_arcFrom.size());
+    header.fingerprint = m_fingerprint;
+    header.payloadSize = static_cast<quint64>(payload.size());
+    header.checksum = BinarySnapshot::checksum(payload.constData(), payload.size());
+    
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(payload);
+    return file.commit();
+}
+
+bool ContractionHierarchy::load(const QString& filename, const Graph& graph) {
+    return load(filename, graph.getSnapshot(), graph.getStructureVersion(), graph.getClosureVersion());
+}
+
+bool ContractionHierarchy::load(const QString& filename, const GraphSnapshot& snapshot,
+                                quint64 structureVersion, quint64 closureVersion) {
+    MappedFile file(filename);
+    if (!file.open() || file.size() < qint64(sizeof(HierarchyHeader))) return false;
+    
+    HierarchyHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, HierarchyMagic, sizeof(header.magic)) != 0 ||
+        header.version != FormatVersion || header.byteOrderMark != ByteOrderMark ||
+        header.payloadSize != quint64(file.size() - qint64(sizeof(header)))) {
+        return false;
+    }
+    
+    // A hierarchy built for any other network, or other closures, is useless
+    if (header.nodeCount != quint32(snapshot.nodeCount()) || header.fingerprint != fingerprint(snapshot)) {
+        return false;
+    }
+    
+    const char* cursor = file.data() + sizeof(header);
+    const char* end = cursor + header.payloadSize;
+    if (BinarySnapshot::checksum(cursor, end - cursor) != header.checksum) return false;
+    
+    qint64 n = header.nodeCount;
+    qint64 m = header.arcCount;
+    QVector<int> rank;
+    QVector<int> arcFrom;
+    QVector<int> arcTo;
+    QVector<double> arcWeight;
+    QVector<int> arcFirst;
+    QVector<int> arcSecond;
+    if (!readSection(cursor, end, rank, n) ||
+        !readSection(cursor, end, arcFrom, m) ||
+        !readSection(cursor, end, arcTo, m) ||
+        !readSection(cursor, end, arcWeight, m) ||
+        !readSection(cursor, end, arcFirst, m) ||
+        !readSection(cursor, end, arcSecond, m)) {
+        return false;
+    }
+    
+    for (int value : rank) {
+        if (value < 0 || value >= n) return false;
+    }
+    // Children must precede their parent so unpacking always terminates
+    for (qint64 arc = 0; arc < m; ++arc) {
+        if (arcFrom[arc] < 0 || arcFrom[arc] >= n || arcTo[arc] < 0 || arcTo[arc] >= n) return false;
+        if ((arcFirst[arc] == -1) != (arcSecond[arc] == -1)) return false;
+        if (arcFirst[arc] < -1 || arcFirst[arc] >= arc || arcSecond[arc] < -1 || arcSecond[arc] >= arc) return false;
+    }
+    
+    m_nodeCount = static_cast<int>(n);
+    m_rank = rank;
+    m_arcFrom = arcFrom;
+    m_arcTo = arcTo;
+    m_arcWeight = arcWeight;
+    m_arcFirst = arcFirst;
+    m_arcSecond = arcSecond;
+    m_fingerprint = header.fingerprint;
+    buildSearchGraph();
+    m_valid = true;
+    m_structureVersion = structureVersion;
+    m_closureVersion = closureVersion;
+    return true;
+}
+
+quint64 ContractionHierarchy::fingerprint(const GraphSnapshot& snapshot) {
+    quint64 sections[5] = {
+        BinarySnapshot::checksum(reinterpret_cast<const char*>(snapshot.stationIds().constData()),
+                                 snapshot.stationIds().size() * qint64(sizeof(int))),
+        BinarySnapshot::checksum(reinterpret_cast<const char*>(snapshot.offsets().constData()),
+                                 snapshot.offsets().size() * qint64(sizeof(int))),
+        BinarySnapshot::checksum(reinterpret_cast<const char*>(snapshot.targets().constData()),
+                                 snapshot.targets().size() * qint64(sizeof(int))),
+        BinarySnapshot::checksum(reinterpret_cast<const char*>(snapshot.weights().constData()),
+                                 snapshot.weights().size() * qint64(sizeof(double))),
+        BinarySnapshot::checksum(snapshot.closed().constData(), snapshot.closed().size())
+    };
+    return BinarySnapshot::checksum(reinterpret_cast<const char*>(sections), sizeof(sections));
+}
+
+int ContractionHierarchy::nodeCount() const { return m_nodeCount; }
+
+int ContractionHierarchy::arcCount() const { return m_arcFrom.size(); }
+
+int ContractionHierarchy::shortcutCount() const {
+    return static_cast<int>(std::count_if(m_arcFirst.begin(), m_arcFirst.end(), [](int child) { return child != -1; }));
+}
+
+double ContractionHierarchy::query(int fromIndex, int toIndex, QVector<int>& path) {
+    const double infinity = std::numeric_limits<double>::infinity();
+    path.clear();
+    if (fromIndex == toIndex) {
+        path.append(fromIndex);
+        return 0.0;
+    }
+    
+    m_forwardDistance[fromIndex] = 0.0;
+    m_backwardDistance[toIndex] = 0.0;
+    m_touched.append(fromIndex);
+    m_touched.append(toIndex);
+    m_forwardHeap.push(fromIndex, 0.0);
+    m_backwardHeap.push(toIndex, 0.0);
+    
+    double best = infinity;
+    int meeting = -1;
+    
+    // Each side stops once its frontier can no longer beat the best meeting
+    // cost; until then the side with the closer frontier goes next
+    while (true) {
+        bool forwardOpen = !m_forwardHeap.isEmpty() && m_forwardHeap.topKey() < best;
+        bool backwardOpen = !m_backwardHeap.isEmpty() && m_backwardHeap.topKey() < best;
+        if (!forwardOpen && !backwardOpen) break;
+        
+        bool forward = forwardOpen && (!backwardOpen || m_forwardHeap.topKey() <= m_backwardHeap.topKey());
+        IndexedMinHeap& heap = forward ? m_forwardHeap : m_backwardHeap;
+        QVector<double>& distance = forward ? m_forwardDistance : m_backwardDistance;
+        QVector<int>& parent = forward ? m_forwardParent : m_backwardParent;
+        const QVector<double>& otherDistance = forward ? m_backwardDistance : m_forwardDistance;
+        const QVector<int>& arcOffsets = forward ? m_forwardOffsets : m_backwardOffsets;
+        const QVector<int>& arcs = forward ? m_forwardArcs : m_backwardArcs;
+        const QVector<int>& arcEnd = forward ? m_arcTo : m_arcFrom;
+        
+        int current = heap.popMin();
+        if (distance[current] + otherDistance[current] < best) {
+            best = distance[current] + otherDistance[current];
+            meeting = current;
+        }
+        
+        for (int i = arcOffsets[current]; i < arcOffsets[current + 1]; ++i) {
+            int arc = arcs[i];
+            int next = arcEnd[arc];
+            double newDistance = distance[current] + m_arcWeight[arc];
+            if (newDistance < distance[next]) {
+                if (distance[next] == infinity && otherDistance[next] == infinity) {
+                    m_touched.append(next);
+                }
+                distance[next] = newDistance;
+                parent[next] = arc;
+                heap.pushOrDecrease(next, newDistance);
+            }
+        }
+    }
+    
+    if (meeting != -1) {
+        QVector<int> forwardArcs;
+        for (int node = meeting; node != fromIndex; node = m_arcFrom[m_forwardParent[node]]) {
+            forwardArcs.append(m_forwardParent[node]);
+        }
+        path.append(fromIndex);
+        for (int i = forwardArcs.size() - 1; i >= 0; --i) {
+            unpack(forwardArcs[i], path);
+        }
+        for (int node = meeting; node != toIndex; node = m_arcTo[m_backwardParent[node]]) {
+            unpack(m_backwardParent[node], path);
+        }
+    }
+    
+    for (int node : m_touched) {
+        m_forwardDistance[node] = infinity;
+        m_backwardDistance[node] = infinity;
+        m_forwardParent[node] = -1;
+        m_backwardParent[node] = -1;
+    }
+    m_touched.clear();
+    m_forwardHeap.clear();
+    m_backwardHeap.clear();
+    
+    return best;
+}
+
+void ContractionHierarchy::buildSearchGraph() {
+    int n = m_nodeCount;
+    int m = m_arcFrom.size();
+    
+    // Every arc climbs from one end to the other, so it is searched forward
+    // from its tail or backward from its head, never both
+    m_forwardOffsets.fill(0, n + 1);
+    m_backwardOffsets.fill(0, n + 1);
+    for (int arc = 0; arc < m; ++arc) {
+        if (m_rank[m_arcFrom[arc]] < m_rank[m_arcTo[arc]]) m_forwardOffsets[m_arcFrom[arc] + 1]++;
+        else m_backwardOffsets[m_arcTo[arc] + 1]++;
+    }
+    for (int i = 0; i < n; ++i) {
+        m_forwardOffsets[i + 1] += m_forwardOffsets[i];
+        m_backwardOffsets[i + 1] += m_backwardOffsets[i];
+    }
+    
+    m_forwardArcs.resize(m_forwardOffsets[n]);
+    m_backwardArcs.resize(m_backwardOffsets[n]);
+    QVector<int> forwardCursor = m_forwardOffsets;
+    QVector<int> backwardCursor = m_backwardOffsets;
+    for (int arc = 0; arc < m; ++arc) {
+        if (m_rank[m_arcFrom[arc]] < m_rank[m_arcTo[arc]]) m_forwardArcs[forwardCursor[m_arcFrom[arc]]++] = arc;
+        else m_backwardArcs[backwardCursor[m_arcTo[arc]]++] = arc;
+    }
+    
+    m_forwardDistance.fill(std::numeric_limits<double>::infinity(), n);
+    m_backwardDistance.fill(std::numeric_limits<double>::infinity(), n);
+    m_forwardParent.fill(-1, n);
+    m_backwardParent.fill(-1, n);
+    m_touched.clear();
+    m_forwardHeap.reset(n);
+    m_backwardHeap.reset(n);
+}
+
+void ContractionHierarchy::unpack(int arc, QVector<int>& path) const {
+    // Appends every station after the arc's tail, expanding shortcuts in order
+    QVector<int> stack;
+    stack.append(arc);
+    while (!stack.isEmpty()) {
+        int current = stack.takeLast();
+        if (m_arcFirst[current] == -1) {
+            path.append(m_arcTo[current]);
+        } else {
+            stack.append(m_arcSecond[current]);
+            stack.append(m_arcFirst[current]);
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include "IndexedMinHeap.h"
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+class Graph;
+class GraphSnapshot;
+
+/**
+ * @brief Contraction Hierarchies over the open edges of the graph snapshot
+ *
+ * Stations are contracted one by one in order of edge difference,
+ * contracted neighbours and depth; a shortcut u -> w is added for every u -> v -> w
+ * that a bounded witness search cannot beat. Each arc is either an
+ * original edge or a shortcut referring to the two arcs it replaces, so
+ * query results unpack back into station paths.
+ *
+ * Queries run a bidirectional Dijkstra that only climbs to higher ranks:
+ * forward along arcs leaving a station, backward along arcs entering it.
+ * Closed edges are left out of the hierarchy, so closures require a
+ * rebuild just like structural changes. The snapshot overloads of build()
+ * and load() only read their arguments, so they can run on a copy of the
+ * snapshot in another thread.
+ */
+class ContractionHierarchy {
+public:
+    static const quint32 FormatVersion = 1;
+    
+    ContractionHierarchy();
+    
+    bool isCurrent(const Graph& graph) const;
+    void build(const Graph& graph);
+    void build(const GraphSnapshot& snapshot, quint64 structureVersion, quint64 closureVersion);
+    void clear();
+    
+    bool save(const QString& filename) const;
+    bool load(const QString& filename, const Graph& graph);
+    bool load(const QString& filename, const GraphSnapshot& snapshot,
+              quint64 structureVersion, quint64 closureVersion);
+    static quint64 fingerprint(const GraphSnapshot& snapshot);
+    
+    int nodeCount() const;
+    int arcCount() const;
+    int shortcutCount() const;
+    
+    double query(int fromIndex, int toIndex, QVector<int>& path);
+
+private:
+    int m_nodeCount;
+    QVector<int> m_rank;
+    QVector<int> m_arcFrom;
+    QVector<int> m_arcTo;
+    QVector<double> m_arcWeight;
+    QVector<int> m_arcFirst;
+    QVector<int> m_arcSecond;
+    
+    // Upward arcs in CSR form: forward lists arcs leaving a station towards
+    // a higher rank, backward lists arcs entering it from a higher rank
+    QVector<int> m_forwardOffsets;
+    QVector<int> m_forwardArcs;
+    QVector<int> m_backwardOffsets;
+    QVector<int> m_backwardArcs;
+    
+    quint64 m_fingerprint;
+    bool m_valid;
+    quint64 m_structureVersion;
+    quint64 m_closureVersion;
+    
+    // Query buffers, reset through the touched list after every query
+    QVector<double> m_forwardDistance;
+    QVector<double> m_backwardDistance;
+    QVector<int> m_forwardParent;
+    QVector<int> m_backwardParent;
+    QVector<int> m_touched;
+    IndexedMinHeap m_forwardHeap;
+    IndexedMinHeap m_backwardHeap;
+    
+    void buildSearchGraph();
+    void unpack(int arc, QVector<int>& path) const;
+};
+
+#endif // CONTRACTIONHIERARCHY_H
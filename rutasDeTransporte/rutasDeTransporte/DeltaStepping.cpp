@@ -0,0 +1,249 @@
+#include "DeltaStepping.h"
+#include "GraphSnapshot.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Stations relaxed per parallel task; smaller frontiers run inline
+const int ChunkSize = 2048;
+
+// Caps the cyclic bucket array when the width is tiny next to the heaviest edge
+const double MaxBucketCount = 65536.0;
+
+double automaticWidth(const GraphSnapshot& snapshot, double maxWeight) {
+    // Meyer and Sanders: about the heaviest edge over the average degree
+    int n = snapshot.nodeCount();
+    if (n == 0 || snapshot.edgeCount() == 0 || maxWeight <= 0.0) return 1.0;
+    return maxWeight * n / snapshot.edgeCount();
+}
+
+}
+
+DeltaStepping::DeltaStepping() : m_bucketWidth(0.0) {}
+
+void DeltaStepping::setBucketWidth(double width) {
+    m_bucketWidth = width;
+}
+
+double DeltaStepping::bucketWidth() const { return m_bucketWidth; }
+
+void DeltaStepping::run(const GraphSnapshot& snapshot, int sourceIdx) {
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    int n = snapshot.nodeCount();
+    
+    m_distances.fill(std::numeric_limits<double>::infinity(), n);
+    m_parents.fill(-1, n);
+    m_phaseStamp.fill(-1, n);
+    m_settledStamp.fill(-1, n);
+    m_requests.resize(ParallelFor::workerCount());
+    
+    double maxWeight = 0.0;
+    for (int e = 0; e < weights.size(); ++e) {
+        if (!closed[e]) maxWeight = qMax(maxWeight, weights[e]);
+    }
+    double width = m_bucketWidth > 0.0 ? m_bucketWidth : automaticWidth(snapshot, maxWeight);
+    width = qMax(width, maxWeight / MaxBucketCount);
+    // Pending distances never run more than one heavy edge past the current
+    // bucket, so this many slots can be reused cyclically
+    int bucketCount = int(maxWeight / width) + 2;
+    m_buckets.resize(bucketCount);
+    for (QVector<int>& bucket : m_buckets) {
+        bucket.clear();
+    }
+    
+    m_distances[sourceIdx] = 0.0;
+    m_buckets[0].append(sourceIdx);
+    
+    int phase = 0;
+    int round = 0;
+    int emptySlots = 0;
+    for (qint64 current = 0; emptySlots < bucketCount; ++current) {
+        QVector<int>& slot = m_buckets[current % bucketCount];
+        if (slot.isEmpty()) {
+            emptySlots++;
+            continue;
+        }
+        emptySlots = 0;
+        round++;
+        
+        m_settled.clear();
+        while (!slot.isEmpty()) {
+            // Entries are stale once their station moved to a lower bucket,
+            // and a station queued twice in one phase is relaxed once
+            std::swap(m_frontier, slot);
+            slot.clear();
+            phase++;
+            int kept = 0;
+            for (int node : m_frontier) {
+                if (qint64(m_distances[node] / width) != current || m_phaseStamp[node] == phase) continue;
+                m_phaseStamp[node] = phase;
+                m_frontier[kept++] = node;
+                if (m_settledStamp[node] != round) {
+                    m_settledStamp[node] = round;
+                    m_settled.append(node);
+                }
+            }
+            m_frontier.resize(kept);
+            
+            relax(snapshot, m_frontier, width, true);
+            applyRequests(width);
+        }
+        
+        relax(snapshot, m_settled, width, false);
+        applyRequests(width);
+    }
+    
+    // Equal-distance tight edges (zero or vanishing weights) make the settle
+    // order more than a sort by distance and index, so those graphs redo the
+    // choice against Dijkstra's actual order
+    if (!assignParents(snapshot, sourceIdx, false)) {
+        rankBySettleOrder(snapshot, sourceIdx);
+        assignParents(snapshot, sourceIdx, true);
+    }
+}
+
+const QVector<double>& DeltaStepping::distances() const { return m_distances; }
+
+const QVector<int>& DeltaStepping::parents() const { return m_parents; }
+
+void DeltaStepping::relax(const GraphSnapshot& snapshot, const QVector<int>& nodes, double width, bool light) {
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    int tasks = (nodes.size() + ChunkSize - 1) / ChunkSize;
+    
+    // Distances are only read here; requests go to the worker's own list
+    ParallelFor::run(tasks, [&](int task, int worker) {
+        QVector<Request>& requests = m_requests[worker];
+        int end = qMin(static_cast<int>(nodes.size()), (task + 1) * ChunkSize);
+        for (int i = task * ChunkSize; i < end; ++i) {
+            int node = nodes[i];
+            double distance = m_distances[node];
+            for (int e = offsets[node]; e < offsets[node + 1]; ++e) {
+                if (closed[e] || (weights[e] <= width) != light) continue;
+                int next = targets[e];
+                double newDistance = distance + weights[e];
+                if (newDistance < m_distances[next]) requests.append(Request{next, newDistance});
+            }
+        }
+    });
+}
+
+void DeltaStepping::applyRequests(double width) {
+    int bucketCount = m_buckets.size();
+    for (QVector<Request>& requests : m_requests) {
+        for (const Request& request : requests) {
+            if (request.distance < m_distances[request.node]) {
+                m_distances[request.node] = request.distance;
+                m_buckets[qint64(request.distance / width) % bucketCount].append(request.node);
+            }
+        }
+        requests.clear();
+    }
+}
+
+bool DeltaStepping::assignParents(const GraphSnapshot& snapshot, int sourceIdx, bool useRank) {
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    const QVector<int>& reverseOffsets = snapshot.reverseOffsets();
+    const QVector<int>& reverseSources = snapshot.reverseSources();
+    const QVector<int>& reverseEdges = snapshot.reverseEdges();
+    const double infinity = std::numeric_limits<double>::infinity();
+    int n = snapshot.nodeCount();
+    std::atomic<bool> equalTight(false);
+    
+    ParallelFor::run((n + ChunkSize - 1) / ChunkSize, [&](int task, int) {
+        int end = qMin(n, (task + 1) * ChunkSize);
+        for (int node = task * ChunkSize; node < end; ++node) {
+            double distance = m_distances[node];
+            int best = -1;
+            if (node != sourceIdx && distance != infinity) {
+                for (int r = reverseOffsets[node]; r < reverseOffsets[node + 1]; ++r) {
+                    int e = reverseEdges[r];
+                    int source = reverseSources[r];
+                    if (closed[e] || source == node || m_distances[source] + weights[e] != distance) continue;
+                    
+                    if (useRank) {
+                        if (m_rank[source] < m_rank[node] && (best == -1 || m_rank[source] < m_rank[best])) best = source;
+                    } else {
+                        if (m_distances[source] == distance) equalTight.store(true, std::memory_order_relaxed);
+                        if (best == -1 || m_distances[source] < m_distances[best] ||
+                            (m_distances[source] == m_distances[best] && source < best)) {
+                            best = source;
+                        }
+                    }
+                }
+            }
+            m_parents[node] = best;
+        }
+    });
+    
+    return !equalTight.load();
+}
+
+void DeltaStepping::rankBySettleOrder(const GraphSnapshot& snapshot, int sourceIdx) {
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    const QVector<int>& reverseOffsets = snapshot.reverseOffsets();
+    const QVector<int>& reverseSources = snapshot.reverseSources();
+    const QVector<int>& reverseEdges = snapshot.reverseEdges();
+    int n = snapshot.nodeCount();
+    
+    QVector<int>& order = m_frontier;
+    order.clear();
+    for (int node = 0; node < n; ++node) {
+        if (m_distances[node] != std::numeric_limits<double>::infinity()) order.append(node);
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return m_distances[a] < m_distances[b] || (m_distances[a] == m_distances[b] && a < b);
+    });
+    
+    // Within one distance, Dijkstra settles the smallest index among the
+    // stations already holding that key: those with a strictly closer tight
+    // parent, plus those reached from an already settled one at no cost
+    m_rank.fill(-1, n);
+    int nextRank = 0;
+    std::priority_queue<int, std::vector<int>, std::greater<int>> available;
+    for (int begin = 0; begin < order.size();) {
+        double distance = m_distances[order[begin]];
+        int end = begin;
+        while (end < order.size() && m_distances[order[end]] == distance) ++end;
+        
+        for (int i = begin; i < end; ++i) {
+            int node = order[i];
+            bool reached = node == sourceIdx;
+            for (int r = reverseOffsets[node]; r < reverseOffsets[node + 1] && !reached; ++r) {
+                int source = reverseSources[r];
+                reached = !closed[reverseEdges[r]] && m_distances[source] < distance &&
+                          m_distances[source] + weights[reverseEdges[r]] == distance;
+            }
+            if (reached) available.push(node);
+        }
+        while (!available.empty()) {
+            int node = available.top();
+            available.pop();
+            if (m_rank[node] != -1) continue;
+            m_rank[node] = nextRank++;
+            for (int e = offsets[node]; e < offsets[node + 1]; ++e) {
+                int next = targets[e];
+                if (!closed[e] && m_rank[next] == -1 && m_distances[next] == distance &&
+                    distance + weights[e] == distance) {
+                    available.push(next);
+                }
+            }
+        }
+        begin = end;
+    }
+    order.clear();
+}
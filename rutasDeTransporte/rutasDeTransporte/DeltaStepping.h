@@ -0,0 +1,62 @@
+#ifndef DELTASTEPPING_H
+#define DELTASTEPPING_H
+
+#include <QVector>
+#include <QtGlobal>
+
+class GraphSnapshot;
+
+/**
+ * @brief Full shortest-path trees by delta-stepping, relaxing in parallel
+ *
+ * Tentative distances are kept in buckets of a fixed width. The smallest
+ * bucket is emptied in phases: its stations relax their light edges (no
+ * heavier than the width) in parallel chunks, which may refill the same
+ * bucket, and once it stays empty the stations it held relax their heavy
+ * edges. Relaxations only produce requests; they are applied between
+ * phases on the calling thread, so distances are never written
+ * concurrently.
+ *
+ * Distances do not depend on the relaxation order. Parents are chosen
+ * afterwards: every station takes the tight in-neighbour a sequential
+ * Dijkstra would have settled first (smallest distance, then smallest
+ * station index), so the tree matches Dijkstra's exactly, ties included.
+ */
+class DeltaStepping {
+public:
+    DeltaStepping();
+    
+    void setBucketWidth(double width);
+    double bucketWidth() const;
+    
+    void run(const GraphSnapshot& snapshot, int sourceIdx);
+    const QVector<double>& distances() const;
+    const QVector<int>& parents() const;
+    
+private:
+    struct Request {
+        int node;
+        double distance;
+    };
+    
+    // Zero picks a width from the heaviest edge and the average degree
+    double m_bucketWidth;
+    QVector<double> m_distances;
+    QVector<int> m_parents;
+    
+    // Cyclic buckets of station indices, filtered lazily when emptied
+    QVector<QVector<int>> m_buckets;
+    QVector<int> m_frontier;
+    QVector<int> m_settled;
+    QVector<int> m_phaseStamp;
+    QVector<int> m_settledStamp;
+    QVector<QVector<Request>> m_requests;
+    QVector<int> m_rank;
+    
+    void relax(const GraphSnapshot& snapshot, const QVector<int>& nodes, double width, bool light);
+    void applyRequests(double width);
+    bool assignParents(const GraphSnapshot& snapshot, int sourceIdx, bool useRank);
+    void rankBySettleOrder(const GraphSnapshot& snapshot, int sourceIdx);
+};
+
+#endif // DELTASTEPPING_H
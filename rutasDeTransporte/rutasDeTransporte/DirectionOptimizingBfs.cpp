@@ -0,0 +1,178 @@
+#include "DirectionOptimizingBfs.h"
+#include "GraphSnapshot.h"
+#include <QtAlgorithms>
+#include <utility>
+
+namespace {
+
+// Switch thresholds from Beamer et al.: go bottom-up once the frontier's
+// edges exceed 1/Alpha of the unexplored ones, and back top-down once a
+// shrinking frontier holds fewer than 1/Beta of the stations
+const qint64 Alpha = 14;
+const qint64 Beta = 24;
+
+// A frontier averaging fewer edges per station than this is sparse
+// suburb, where a bottom-up step mostly rescans stations without a
+// frontier parent; only denser frontiers such as an urban core switch
+const qint64 MinBottomUpDegree = 8;
+
+}
+
+DirectionOptimizingBfs::DirectionOptimizingBfs() {}
+
+void DirectionOptimizingBfs::run(const GraphSnapshot& snapshot, int originIdx, int stopAtIdx) {
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& reverseOffsets = snapshot.reverseOffsets();
+    int n = snapshot.nodeCount();
+    int words = (n + 63) / 64;
+    
+    m_hops.fill(-1, n);
+    m_visitedBits.fill(0, words);
+    m_frontierBits.fill(0, words);
+    if (m_onPath.size() != n) m_onPath.fill(0, n);
+    m_frontier.clear();
+    m_next.clear();
+    
+    m_hops[originIdx] = 0;
+    m_visitedBits[originIdx >> 6] |= quint64(1) << (originIdx & 63);
+    m_frontier.append(originIdx);
+    
+    // Edges pointing into stations not reached yet, closed ones included
+    qint64 unexploredEdges = snapshot.edgeCount() - (reverseOffsets[originIdx + 1] - reverseOffsets[originIdx]);
+    bool bottomUp = false;
+    int previousSize = 0;
+    
+    for (int level = 0; !m_frontier.isEmpty(); ++level) {
+        if (stopAtIdx != -1 && m_hops[stopAtIdx] != -1) break;
+        
+        qint64 frontierEdges = 0;
+        for (int node : m_frontier) {
+            frontierEdges += offsets[node + 1] - offsets[node];
+        }
+        if (!bottomUp && frontierEdges * Alpha > unexploredEdges &&
+            frontierEdges >= MinBottomUpDegree * m_frontier.size()) {
+            bottomUp = true;
+        } else if (bottomUp && m_frontier.size() < previousSize && m_frontier.size() * Beta < n) {
+            bottomUp = false;
+        }
+        
+        if (bottomUp) stepBottomUp(snapshot, level);
+        else stepTopDown(snapshot, level);
+        
+        for (int node : m_next) {
+            unexploredEdges -= reverseOffsets[node + 1] - reverseOffsets[node];
+        }
+        previousSize = m_frontier.size();
+        std::swap(m_frontier, m_next);
+        m_next.clear();
+    }
+}
+
+int DirectionOptimizingBfs::hops(int index) const { return m_hops[index]; }
+
+const QVector<int>& DirectionOptimizingBfs::hopDistances() const { return m_hops; }
+
+QVector<int> DirectionOptimizingBfs::path(const GraphSnapshot& snapshot, int originIdx, int destIdx) {
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<char>& closed = snapshot.closed();
+    const QVector<int>& reverseOffsets = snapshot.reverseOffsets();
+    const QVector<int>& reverseSources = snapshot.reverseSources();
+    const QVector<int>& reverseEdges = snapshot.reverseEdges();
+    QVector<int> result;
+    if (m_hops[destIdx] == -1) return result;
+    
+    // Mark every station that lies on some shortest-hop path to the
+    // destination; levels below the destination's are complete even when
+    // run() stopped early. The frontier buffer is free to hold the list
+    QVector<int>& cone = m_frontier;
+    cone.clear();
+    cone.append(destIdx);
+    m_onPath[destIdx] = 1;
+    for (int i = 0; i < cone.size(); ++i) {
+        int node = cone[i];
+        if (node == originIdx) continue;
+        for (int r = reverseOffsets[node]; r < reverseOffsets[node + 1]; ++r) {
+            int source = reverseSources[r];
+            if (closed[reverseEdges[r]] || m_onPath[source] || m_hops[source] != m_hops[node] - 1) continue;
+            m_onPath[source] = 1;
+            cone.append(source);
+        }
+    }
+    
+    // Taking the first edge that stays inside the marked set at each step
+    // gives the path whose edge positions are lexicographically smallest,
+    // the one a FIFO top-down BFS would record
+    result.append(originIdx);
+    for (int node = originIdx; node != destIdx;) {
+        for (int e = offsets[node]; e < offsets[node + 1]; ++e) {
+            int next = targets[e];
+            if (!closed[e] && m_onPath[next] && m_hops[next] == m_hops[node] + 1) {
+                node = next;
+                break;
+            }
+        }
+        result.append(node);
+    }
+    
+    for (int node : cone) {
+        m_onPath[node] = 0;
+    }
+    cone.clear();
+    return result;
+}
+
+void DirectionOptimizingBfs::stepTopDown(const GraphSnapshot& snapshot, int level) {
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<char>& closed = snapshot.closed();
+    
+    for (int node : m_frontier) {
+        for (int e = offsets[node]; e < offsets[node + 1]; ++e) {
+            int next = targets[e];
+            if (closed[e] || m_hops[next] != -1) continue;
+            m_hops[next] = level + 1;
+            m_visitedBits[next >> 6] |= quint64(1) << (next & 63);
+            m_next.append(next);
+        }
+    }
+}
+
+void DirectionOptimizingBfs::stepBottomUp(const GraphSnapshot& snapshot, int level) {
+    const QVector<char>& closed = snapshot.closed();
+    const QVector<int>& reverseOffsets = snapshot.reverseOffsets();
+    const QVector<int>& reverseSources = snapshot.reverseSources();
+    const QVector<int>& reverseEdges = snapshot.reverseEdges();
+    int n = snapshot.nodeCount();
+    
+    for (int node : m_frontier) {
+        m_frontierBits[node >> 6] |= quint64(1) << (node & 63);
+    }
+    
+    // Whole words of visited stations are skipped without looking at them
+    for (int word = 0; word < m_visitedBits.size(); ++word) {
+        quint64 unvisited = ~m_visitedBits[word];
+        while (unvisited) {
+            int node = word * 64 + int(qCountTrailingZeroBits(unvisited));
+            unvisited &= unvisited - 1;
+            if (node >= n) break;
+            
+            for (int r = reverseOffsets[node]; r < reverseOffsets[node + 1]; ++r) {
+                // The frontier bitset is small enough to stay in cache, so it
+                // is tested before the closure flag of the edge
+                int source = reverseSources[r];
+                if (!(m_frontierBits[source >> 6] & (quint64(1) << (source & 63))) || closed[reverseEdges[r]]) continue;
+                m_hops[node] = level + 1;
+                m_next.append(node);
+                break;
+            }
+        }
+    }
+    
+    for (int node : m_next) {
+        m_visitedBits[node >> 6] |= quint64(1) << (node & 63);
+    }
+    for (int node : m_frontier) {
+        m_frontierBits[node >> 6] &= ~(quint64(1) << (node & 63));
+    }
+}
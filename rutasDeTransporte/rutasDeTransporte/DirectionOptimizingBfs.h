@@ -0,0 +1,45 @@
+#ifndef DIRECTIONOPTIMIZINGBFS_H
+#define DIRECTIONOPTIMIZINGBFS_H
+
+#include <QVector>
+#include <QtGlobal>
+
+class GraphSnapshot;
+
+/**
+ * @brief Hop-count BFS that switches between top-down and bottom-up steps
+ *
+ * Small frontiers expand top-down over their outgoing edges. Once the
+ * frontier's edges outnumber a fraction of the edges still unexplored, the
+ * search goes bottom-up: every unvisited station scans its incoming edges
+ * and stops at the first parent in the frontier bitset, which skips most
+ * of the already-visited neighbours a top-down step would check (Beamer's
+ * direction-optimizing BFS). Closed edges are ignored.
+ *
+ * Bottom-up steps pick arbitrary parents, so paths are not read from a
+ * parent array. path() instead returns the shortest-hop path whose edges
+ * come first in adjacency order at every step, which is exactly the path a
+ * FIFO top-down BFS finds.
+ */
+class DirectionOptimizingBfs {
+public:
+    DirectionOptimizingBfs();
+    
+    void run(const GraphSnapshot& snapshot, int originIdx, int stopAtIdx = -1);
+    int hops(int index) const;
+    const QVector<int>& hopDistances() const;
+    QVector<int> path(const GraphSnapshot& snapshot, int originIdx, int destIdx);
+    
+private:
+    QVector<int> m_hops;
+    QVector<int> m_frontier;
+    QVector<int> m_next;
+    QVector<quint64> m_frontierBits;
+    QVector<quint64> m_visitedBits;
+    QVector<char> m_onPath;
+    
+    void stepTopDown(const GraphSnapshot& snapshot, int level);
+    void stepBottomUp(const GraphSnapshot& snapshot, int level);
+};
+
+#endif // DIRECTIONOPTIMIZINGBFS_H
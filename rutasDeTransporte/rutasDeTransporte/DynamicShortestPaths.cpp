@@ -0,0 +1,203 @@
+#include "DynamicShortestPaths.h"
+#include "Graph.h"
+#include "GraphSnapshot.h"
+#include <algorithm>
+#include <limits>
+
+DynamicShortestPaths::DynamicShortestPaths()
+    : m_valid(false), m_structureVersion(0), m_closureVersion(0) {}
+
+void DynamicShortestPaths::addHub(int stationId) {
+    if (m_hubs.contains(stationId)) return;
+    m_hubs.append(stationId);
+    m_valid = false;
+}
+
+void DynamicShortestPaths::removeHub(int stationId) {
+    int position = m_hubs.indexOf(stationId);
+    if (position == -1) return;
+    m_hubs.removeAt(position);
+    if (m_valid) m_trees.removeAt(position);
+}
+
+bool DynamicShortestPaths::isHub(int stationId) const {
+    return m_hubs.contains(stationId);
+}
+
+const QVector<int>& DynamicShortestPaths::hubs() const { return m_hubs; }
+
+bool DynamicShortestPaths::isCurrent(const Graph& graph) const {
+    return m_valid && m_structureVersion == graph.getStructureVersion() &&
+           m_closureVersion == graph.getClosureVersion();
+}
+
+void DynamicShortestPaths::rebuild(const Graph& graph) {
+    const GraphSnapshot& snapshot = graph.getSnapshot();
+    int n = snapshot.nodeCount();
+    
+    m_heap.reset(n);
+    m_affected.fill(0, n);
+    m_affectedList.clear();
+    m_closed = snapshot.closed();
+    m_trees.resize(m_hubs.size());
+    for (int i = 0; i < m_hubs.size(); ++i) {
+        m_trees[i].root = snapshot.indexOf(m_hubs[i]);
+        buildTree(snapshot, m_trees[i]);
+    }
+    
+    m_valid = true;
+    m_structureVersion = graph.getStructureVersion();
+    m_closureVersion = graph.getClosureVersion();
+}
+
+void DynamicShortestPaths::edgeChanged(const Graph& graph, int from, int to) {
+    // A structure change renumbers the snapshot, so there is nothing to repair
+    if (!m_valid || m_structureVersion != graph.getStructureVersion()) return;
+    
+    const GraphSnapshot& snapshot = graph.getSnapshot();
+    int tail = snapshot.indexOf(from);
+    int head = snapshot.indexOf(to);
+    if (tail == -1 || head == -1) return;
+    int edge = snapshot.findEdge(tail, head);
+    if (edge == -1 || snapshot.closed()[edge] == m_closed[edge]) return;
+    
+    m_closed[edge] = snapshot.closed()[edge];
+    m_closureVersion++;
+    for (Tree& tree : m_trees) {
+        if (tree.root == -1) continue;
+        if (m_closed[edge]) closeEdge(snapshot, tree, edge, head);
+        else openEdge(snapshot, tree, edge, tail, head);
+    }
+}
+
+void DynamicShortestPaths::clear() {
+    m_trees.clear();
+    m_closed.clear();
+    m_heap.reset(0);
+    m_affected.clear();
+    m_affectedList.clear();
+    m_valid = false;
+}
+
+double DynamicShortestPaths::distance(int hubStationId, int toIndex) const {
+    int position = m_hubs.indexOf(hubStationId);
+    if (!m_valid || position == -1 || m_trees[position].root == -1) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return m_trees[position].distance[toIndex];
+}
+
+QVector<int> DynamicShortestPaths::path(int hubStationId, int toIndex) const {
+    QVector<int> result;
+    if (distance(hubStationId, toIndex) == std::numeric_limits<double>::infinity()) return result;
+    
+    const Tree& tree = m_trees[m_hubs.indexOf(hubStationId)];
+    for (int node = toIndex; node != -1; node = tree.parent[node]) {
+        result.append(node);
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+void DynamicShortestPaths::buildTree(const GraphSnapshot& snapshot, Tree& tree) {
+    int n = snapshot.nodeCount();
+    tree.distance.fill(std::numeric_limits<double>::infinity(), n);
+    tree.parent.fill(-1, n);
+    tree.parentEdge.fill(-1, n);
+    if (tree.root == -1) return;
+    
+    tree.distance[tree.root] = 0.0;
+    m_heap.push(tree.root, 0.0);
+    propagate(snapshot, tree, nullptr);
+}
+
+void DynamicShortestPaths::closeEdge(const GraphSnapshot& snapshot, Tree& tree, int edge, int head) {
+    if (tree.parentEdge[head] != edge) return;
+    
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<int>& reverseOffsets = snapshot.reverseOffsets();
+    const QVector<int>& reverseSources = snapshot.reverseSources();
+    const QVector<int>& reverseEdges = snapshot.reverseEdges();
+    const double infinity = std::numeric_limits<double>::infinity();
+    
+    // Everything hanging below the closed edge loses its distance; the list
+    // doubles as the stack of the subtree walk
+    m_affected[head] = 1;
+    m_affectedList.append(head);
+    for (int i = 0; i < m_affectedList.size(); ++i) {
+        int current = m_affectedList[i];
+        for (int e = offsets[current]; e < offsets[current + 1]; ++e) {
+            int next = targets[e];
+            if (tree.parentEdge[next] == e && !m_affected[next]) {
+                m_affected[next] = 1;
+                m_affectedList.append(next);
+            }
+        }
+    }
+    for (int node : m_affectedList) {
+        tree.distance[node] = infinity;
+        tree.parent[node] = -1;
+        tree.parentEdge[node] = -1;
+    }
+    
+    // Re-attach each cut station through its best open in-edge from the
+    // intact part of the tree, then let Dijkstra settle the rest of the cut
+    for (int node : m_affectedList) {
+        for (int i = reverseOffsets[node]; i < reverseOffsets[node + 1]; ++i) {
+            int source = reverseSources[i];
+            int e = reverseEdges[i];
+            if (m_closed[e] || m_affected[source]) continue;
+            double candidate = tree.distance[source] + weights[e];
+            if (candidate < tree.distance[node]) {
+                tree.distance[node] = candidate;
+                tree.parent[node] = source;
+                tree.parentEdge[node] = e;
+            }
+        }
+        if (tree.distance[node] != infinity) m_heap.push(node, tree.distance[node]);
+    }
+    propagate(snapshot, tree, &m_affected);
+    
+    for (int node : m_affectedList) {
+        m_affected[node] = 0;
+    }
+    m_affectedList.clear();
+}
+
+void DynamicShortestPaths::openEdge(const GraphSnapshot& snapshot, Tree& tree, int edge, int tail, int head) {
+    double candidate = tree.distance[tail] + snapshot.weights()[edge];
+    if (!(candidate < tree.distance[head])) return;
+    
+    tree.distance[head] = candidate;
+    tree.parent[head] = tail;
+    tree.parentEdge[head] = edge;
+    m_heap.push(head, candidate);
+    propagate(snapshot, tree, nullptr);
+}
+
+void DynamicShortestPaths::propagate(const GraphSnapshot& snapshot, Tree& tree, const QVector<char>* region) {
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    
+    // Only strict improvements are relaxed, so stations outside the changed
+    // region keep their parents and the walk stops at its boundary
+    while (!m_heap.isEmpty()) {
+        int current = m_heap.popMin();
+        for (int e = offsets[current]; e < offsets[current + 1]; ++e) {
+            if (m_closed[e]) continue;
+            int next = targets[e];
+            if (region && !(*region)[next]) continue;
+            
+            double newDistance = tree.distance[current] + weights[e];
+            if (newDistance < tree.distance[next]) {
+                tree.distance[next] = newDistance;
+                tree.parent[next] = current;
+                tree.parentEdge[next] = e;
+                m_heap.pushOrDecrease(next, newDistance);
+            }
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef DYNAMICSHORTESTPATHS_H
+#define DYNAMICSHORTESTPATHS_H
+
+#include "IndexedMinHeap.h"
+#include <QVector>
+#include <QtGlobal>
+
+class Graph;
+class GraphSnapshot;
+
+/**
+ * @brief Shortest-path trees from registered hub stations, repaired in
+ *        place when edges close or reopen
+ *
+ * Each hub keeps the distance, parent and parent edge of every station
+ * over the open edges. A closure only matters to a tree that uses the
+ * edge: the subtree below it is cut off and re-attached by a Dijkstra
+ * seeded from its unaffected in-neighbours. A reopening propagates only
+ * the distances it improves. Both cost about the size of the changed
+ * region (Ramalingam-Reps).
+ *
+ * The closure flags the trees reflect are tracked edge by edge, so a flip
+ * that was not reported through edgeChanged leaves the closure version
+ * behind the graph's and the next isCurrent check asks for a rebuild.
+ */
+class DynamicShortestPaths {
+public:
+    DynamicShortestPaths();
+    
+    void addHub(int stationId);
+    void removeHub(int stationId);
+    bool isHub(int stationId) const;
+    const QVector<int>& hubs() const;
+    
+    bool isCurrent(const Graph& graph) const;
+    void rebuild(const Graph& graph);
+    void edgeChanged(const Graph& graph, int from, int to);
+    void clear();
+    
+    double distance(int hubStationId, int toIndex) const;
+    QVector<int> path(int hubStationId, int toIndex) const;
+    
+private:
+    struct Tree {
+        int root;
+        QVector<double> distance;
+        QVector<int> parent;
+        QVector<int> parentEdge;
+    };
+    
+    QVector<int> m_hubs;
+    QVector<Tree> m_trees;
+    QVector<char> m_closed;
+    bool m_valid;
+    quint64 m_structureVersion;
+    quint64 m_closureVersion;
+    
+    // Repair scratch space shared by every tree
+    IndexedMinHeap m_heap;
+    QVector<char> m_affected;
+    QVector<int> m_affectedList;
+    
+    void buildTree(const GraphSnapshot& snapshot, Tree& tree);
+    void closeEdge(const GraphSnapshot& snapshot, Tree& tree, int edge, int head);
+    void openEdge(const GraphSnapshot& snapshot, Tree& tree, int edge, int tail, int head);
+    void propagate(const GraphSnapshot& snapshot, Tree& tree, const QVector<char>* region);
+};
+
+#endif // DYNAMICSHORTESTPATHS_H
@@ -0,0 +1,121 @@
+#include "EdgeIndex.h"
+
+namespace {
+
+const int MinimumBuckets = 16;
+
+}
+
+EdgeIndex::EdgeIndex() : m_size(0) {}
+
+quint64 EdgeIndex::makeKey(int from, int to) {
+    return (static_cast<quint64>(static_cast<quint32>(from)) << 32) | static_cast<quint32>(to);
+}
+
+quint64 EdgeIndex::hash(quint64 key) {
+    // splitmix64 finalizer, so nearby IDs spread over the whole table
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+int EdgeIndex::bucketOf(quint64 key) const {
+    // Returns the bucket holding key, or the empty bucket where it would go
+    int mask = static_cast<int>(m_buckets.size()) - 1;
+    int bucket = static_cast<int>(hash(key) & mask);
+    while (m_buckets[bucket].slot != -1 && m_buckets[bucket].key != key) {
+        bucket = (bucket + 1) & mask;
+    }
+    return bucket;
+}
+
+int EdgeIndex::find(int from, int to) const {
+    if (m_size == 0) return -1;
+    return m_buckets[bucketOf(makeKey(from, to))].slot;
+}
+
+int EdgeIndex::findIncoming(int from, int to) const {
+    if (m_size == 0) return -1;
+    const Bucket& bucket = m_buckets[bucketOf(makeKey(from, to))];
+    return bucket.slot == -1 ? -1 : bucket.incomingSlot;
+}
+
+void EdgeIndex::insert(int from, int to, int slot, int incomingSlot) {
+    if (2 * (m_size + 1) > m_buckets.size()) {
+        rehash(qMax(MinimumBuckets, 2 * static_cast<int>(m_buckets.size())));
+    }
+    quint64 key = makeKey(from, to);
+    Bucket& bucket = m_buckets[bucketOf(key)];
+    if (bucket.slot == -1) m_size++;
+    bucket.key = key;
+    bucket.slot = slot;
+    bucket.incomingSlot = incomingSlot;
+}
+
+void EdgeIndex::setSlot(int from, int to, int slot) {
+    if (m_size == 0) return;
+    Bucket& bucket = m_buckets[bucketOf(makeKey(from, to))];
+    if (bucket.slot != -1) bucket.slot = slot;
+}
+
+void EdgeIndex::setIncomingSlot(int from, int to, int incomingSlot) {
+    if (m_size == 0) return;
+    Bucket& bucket = m_buckets[bucketOf(makeKey(from, to))];
+    if (bucket.slot != -1) bucket.incomingSlot = incomingSlot;
+}
+
+bool EdgeIndex::remove(int from, int to) {
+    if (m_size == 0) return false;
+    
+    int mask = static_cast<int>(m_buckets.size()) - 1;
+    int hole = bucketOf(makeKey(from, to));
+    if (m_buckets[hole].slot == -1) return false;
+    m_buckets[hole].slot = -1;
+    m_size--;
+    
+    // Backward-shift: move later entries of the probe run into the hole when
+    // their home bucket does not lie cyclically in (hole, current]
+    int current = (hole + 1) & mask;
+    while (m_buckets[current].slot != -1) {
+        int home = static_cast<int>(hash(m_buckets[current].key) & mask);
+        bool stays = (hole <= current) ? (hole < home && home <= current)
+                                       : (hole < home || home <= current);
+        if (!stays) {
+            m_buckets[hole] = m_buckets[current];
+            m_buckets[current].slot = -1;
+            hole = current;
+        }
+        current = (current + 1) & mask;
+    }
+    return true;
+}
+
+void EdgeIndex::reserve(int count) {
+    int bucketCount = MinimumBuckets;
+    while (bucketCount < 2 * count) bucketCount *= 2;
+    if (bucketCount > m_buckets.size()) rehash(bucketCount);
+}
+
+void EdgeIndex::clear() {
+    m_buckets.clear();
+    m_size = 0;
+}
+
+int EdgeIndex::size() const { return m_size; }
+
+void EdgeIndex::rehash(int bucketCount) {
+    QVector<Bucket> old;
+    old.swap(m_buckets);
+    m_buckets.fill(Bucket{0, -1, -1}, bucketCount);
+    
+    int mask = bucketCount - 1;
+    for (const Bucket& entry : old) {
+        if (entry.slot == -1) continue;
+        int bucket = static_cast<int>(hash(entry.key) & mask);
+        while (m_buckets[bucket].slot != -1) bucket = (bucket + 1) & mask;
+        m_buckets[bucket] = entry;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef EDGEINDEX_H
+#define EDGEINDEX_H
+
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief Open-addressing hash map from a (from, to) station pair to the
+ *        slot of that edge in the adjacency vector of "from" and to the
+ *        slot of "from" in the incoming list of "to"
+ *
+ * Linear probing over a power-of-two table kept at most half full. Removal
+ * shifts the following entries back instead of leaving tombstones, so
+ * lookups stay short after long add/remove sequences.
+ */
+class EdgeIndex {
+public:
+    EdgeIndex();
+    
+    int find(int from, int to) const;
+    int findIncoming(int from, int to) const;
+    void insert(int from, int to, int slot, int incomingSlot);
+    void setSlot(int from, int to, int slot);
+    void setIncomingSlot(int from, int to, int incomingSlot);
+    bool remove(int from, int to);
+    void reserve(int count);
+    void clear();
+    int size() const;
+    
+private:
+    struct Bucket {
+        quint64 key;
+        int slot;
+        int incomingSlot;
+    };
+    
+    QVector<Bucket> m_buckets;
+    int m_size;
+    
+    static quint64 makeKey(int from, int to);
+    static quint64 hash(quint64 key);
+    int bucketOf(quint64 key) const;
+    void rehash(int bucketCount);
+};
+
+#endif // EDGEINDEX_H
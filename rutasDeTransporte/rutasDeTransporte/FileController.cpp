@@ -3,35 +3,86 @@
 #include "Graph.h"
 #include "ReportManager.h"
 #include "Station.h"
+#include "MappedFile.h"
+#include "LineTokenizer.h"
+#include "ParallelFor.h"
+#include "BinarySnapshot.h"
+#include "GraphSnapshot.h"
+#include "MutationJournal.h"
 #include <QFile>
+#include <QSaveFile>
 #include <QTextStream>
 #include <QStringConverter>
 #include <QDir>
+#include <QFileInfo>
 #include <QSet>
-#include <QRegularExpression>
+#include <cstring>
+
+namespace {
+
+struct RouteRecord {
+    int from;
+    int to;
+    double weight;
+};
+
+// Below this size per chunk, extra threads cost more than they save
+const qint64 RouteChunkBytes = 1 << 20;
+
+}
 
 FileController::FileController(QObject* parent) 
     : QObject(parent), m_tree(nullptr), m_graph(nullptr), 
-      m_reportManager(nullptr), m_dataPath("data") {}
+      m_reportManager(nullptr), m_journal(nullptr), m_dataPath("data") {}
 
 void FileController::setTree(BinarySearchTree* tree) { m_tree = tree; }
 void FileController::setGraph(Graph* graph) { m_graph = graph; }
 void FileController::setReportManager(ReportManager* reportManager) { m_reportManager = reportManager; }
 void FileController::setDataPath(const QString& path) { m_dataPath = path; }
 
+void FileController::setJournal(MutationJournal* journal) {
+    if (m_journal) disconnect(m_journal, nullptr, this, nullptr);
+    m_journal = journal;
+    if (m_journal) connect(m_journal, &MutationJournal::compactionRequested, this, &FileController::compact);
+}
+
 ReportManager* FileController::getReportManager() const { return m_reportManager; }
 
 QString FileController::getStationsFilePath() const { return m_dataPath + "/estaciones.txt"; }
 QString FileController::getRoutesFilePath() const { return m_dataPath + "/rutas.txt"; }
 QString FileController::getClosuresFilePath() const { return m_dataPath + "/cierres.txt"; }
 QString FileController::getReportsFilePath() const { return m_dataPath + "/reportes.txt"; }
+QString FileController::getSnapshotFilePath() const { return m_dataPath + "/red.snap"; }
+QString FileController::getJournalFilePath() const { return m_dataPath + "/cambios.log"; }
+
+bool FileController::isSnapshotCurrent() const {
+    QFileInfo snapshot(getSnapshotFilePath());
+    if (!snapshot.exists()) return false;
+    
+    // Any text file edited after the last save makes the snapshot stale
+    const QString sources[] = { getStationsFilePath(), getRoutesFilePath(), getClosuresFilePath() };
+    for (const QString& source : sources) {
+        QFileInfo info(source);
+        if (info.exists() && info.lastModified() > snapshot.lastModified()) return false;
+    }
+    return true;
+}
 
 bool FileController::loadAll() {
     try {
-        loadStations();
-        loadRoutes();
-        loadClosures();
+        if (m_journal) m_journal->close();
+        if (!isSnapshotCurrent() || !loadSnapshot()) {
+            loadStations();
+            loadRoutes();
+            loadClosures();
+        }
         loadReports();
+        int generation = m_reportManager ? m_reportManager->getGeneration() : 0;
+        replayJournal(generation);
+        if (m_journal) m_journal->setGeneration(generation);
+        if (m_journal && !m_journal->open(getJournalFilePath())) {
+            emit errorOccurred(QString("No se pudo abrir el archivo: %1").arg(getJournalFilePath()));
+        }
         emit dataLoaded(true);
         return true;
     } catch (...) {
@@ -42,70 +93,128 @@ bool FileController::loadAll() {
 }
 
 bool FileController::saveAll() {
+    // Every change is already on disk in the journal, so the full files are
+    // only rewritten when it is due for compaction
+    bool success = true;
+    if (!m_journal || !m_journal->isOpen() ||
+        m_journal->getEntryCount() >= m_journal->getCompactionThreshold()) {
+        success = compact();
+    }
+    emit dataSaved(success);
+    return success;
+}
+
+bool FileController::compact() {
     try {
-        saveStations();
-        saveRoutes();
-        saveClosures();
-        saveReports();
-        emit dataSaved(true);
+        QDir dir;
+        dir.mkpath(m_dataPath);
+        int generation = qMax(m_reportManager ? m_reportManager->getGeneration() : 0,
+                              m_journal ? m_journal->getGeneration() : 0) + 1;
+        if (m_reportManager) m_reportManager->setGeneration(generation);
+        
+        // Each file replaces its old copy atomically; until all of them have,
+        // the journal is the only complete record and must be kept
+        if (!saveStations() || !saveRoutes() || !saveClosures() || !saveReports()) {
+            emit errorOccurred("Error al guardar datos; se conserva el registro de cambios");
+            return false;
+        }
+        saveSnapshot();
+        if (m_journal) m_journal->setGeneration(generation);
+        
+        // A journal that kept its old entries would be skipped as already
+        // compacted on the next start, taking every later change with it;
+        // without it, saveAll() writes the full files instead
+        if (m_journal && m_journal->isOpen() && !m_journal->truncate()) {
+            m_journal->close();
+            emit errorOccurred("No se pudo vaciar el registro de cambios; los cambios se guardarán al salir");
+        }
         return true;
     } catch (...) {
-        emit dataSaved(false);
         emit errorOccurred("Error al guardar datos");
         return false;
     }
 }
 
+int FileController::replayJournal(int generation) {
+    if (!m_tree || !m_graph) return 0;
+    
+    // reportes.txt is committed last, so a newer compaction number there
+    // means every change in this journal already reached the files
+    QVector<MutationJournal::Entry> entries = MutationJournal::readEntries(getJournalFilePath());
+    if (MutationJournal::generationOf(entries) < generation) return 0;
+    for (const MutationJournal::Entry& entry : entries) {
+        switch (entry.operation) {
+        case MutationJournal::Operation::InsertStation: {
+            Station station(entry.first, entry.name);
+            Station existing;
+            if (!m_tree->search(entry.first, existing)) m_tree->insert(station);
+            m_graph->addStation(station);
+            break;
+        }
+        case MutationJournal::Operation::DeleteStation:
+            m_tree->remove(entry.first);
+            m_graph->removeStation(entry.first);
+            break;
+        case MutationJournal::Operation::AddEdge:
+            m_graph->addEdge(entry.first, entry.second, entry.weight, true);
+            break;
+        case MutationJournal::Operation::RemoveEdge:
+            m_graph->removeEdge(entry.first, entry.second, true);
+            break;
+        case MutationJournal::Operation::CloseEdge:
+            m_graph->markEdgeClosed(entry.first, entry.second, true, true);
+            break;
+        case MutationJournal::Operation::ReopenEdge:
+            m_graph->markEdgeClosed(entry.first, entry.second, false, true);
+            break;
+        case MutationJournal::Operation::AppendReport:
+            if (m_reportManager) m_reportManager->addReport(entry.report);
+            break;
+        case MutationJournal::Operation::Compaction:
+            break;
+        }
+    }
+    return entries.size();
+}
+
 void FileController::loadStations() {
     if (!m_tree || !m_graph) {
         emit errorOccurred("Tree o Graph no inicializados");
         return;
     }
     
-    QFile file(getStationsFilePath());
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    MappedFile file(getStationsFilePath());
+    if (!file.open()) {
         emit errorOccurred(QString("No se pudo abrir el archivo: %1").arg(getStationsFilePath()));
         emit stationsLoaded(0);
         return;
     }
     
-    QTextStream in(&file);
-    in.setEncoding(QStringConverter::Utf8);
+    LineTokenizer tokenizer(file.data(), file.size());
     int count = 0;
-    int lineNumber = 0;
+    QVector<Station> stations;
     
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        lineNumber++;
-        
-        if (line.isEmpty() || line.startsWith("#") || line.startsWith("//")) {
-            continue;
-        }
-        
-        QStringList parts;
-        if (line.contains(';')) {
-            parts = line.split(';');
-        } else if (line.contains(',')) {
-            parts = line.split(',');
-        } else if (line.contains('\t')) {
-            parts = line.split('\t');
-        } else {
-            parts = line.split(QRegularExpression("\\s+"));
-        }
-        
-        if (parts.size() >= 2) {
-            bool ok;
-            int id = parts[0].trimmed().toInt(&ok);
-            if (ok && id >= 0) {
-                QString name = parts[1].trimmed();
+    while (tokenizer.nextRecord()) {
+        if (tokenizer.fieldCount() >= 2) {
+            int id;
+            if (tokenizer.toInt(0, id) && id >= 0) {
+                // ID;Nombre;X;Y carries coordinates; with plain spaces as the
+                // separator the extra words always belong to the name
+                double x, y;
+                bool hasCoordinates = tokenizer.fieldCount() == 4 && tokenizer.separator() != ' ' &&
+                                      tokenizer.toDouble(2, x) && tokenizer.toDouble(3, y);
                 
-                for (int i = 2; i < parts.size(); ++i) {
-                    name += " " + parts[i].trimmed();
+                QString name = tokenizer.toString(1);
+                if (!hasCoordinates) {
+                    for (int i = 2; i < tokenizer.fieldCount(); ++i) {
+                        name += " " + tokenizer.toString(i);
+                    }
                 }
                 
                 if (!name.isEmpty()) {
                     Station station(id, name);
-                    m_tree->insert(station);
+                    if (hasCoordinates) station.setCoordinates(x, y);
+                    stations.append(station);
                     m_graph->addStation(station);
                     count++;
                 }
@@ -114,6 +223,7 @@ void FileController::loadStations() {
     }
     
     file.close();
+    m_tree->bulkLoad(stations);
     emit stationsLoaded(count);
 }
 
@@ -123,48 +233,51 @@ void FileController::loadRoutes() {
         return;
     }
     
-    QFile file(getRoutesFilePath());
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    MappedFile file(getRoutesFilePath());
+    if (!file.open()) {
         emit errorOccurred(QString("No se pudo abrir el archivo: %1").arg(getRoutesFilePath()));
         emit routesLoaded(0);
         return;
     }
     
-    QTextStream in(&file);
-    in.setEncoding(QStringConverter::Utf8);
-    int count = 0;
-    int lineNumber = 0;
+    // Split at line boundaries so every chunk parses independently
+    const char* data = file.data();
+    qint64 size = file.size();
+    int chunkCount = static_cast<int>(qBound<qint64>(1, size / RouteChunkBytes, ParallelFor::workerCount()));
+    QVector<qint64> bounds(chunkCount + 1, size);
+    bounds[0] = 0;
+    for (int i = 1; i < chunkCount; ++i) {
+        qint64 position = qMax(bounds[i - 1], size * i / chunkCount);
+        const char* newline = static_cast<const char*>(std::memchr(data + position, '\n', size - position));
+        bounds[i] = newline ? (newline - data) + 1 : size;
+    }
     
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        lineNumber++;
+    QVector<QVector<RouteRecord>> chunks(chunkCount);
+    ParallelFor::run(chunkCount, [&](int chunk, int) {
+        LineTokenizer tokenizer(data + bounds[chunk], bounds[chunk + 1] - bounds[chunk]);
+        QVector<RouteRecord>& records = chunks[chunk];
         
-        if (line.isEmpty() || line.startsWith("#") || line.startsWith("//")) {
-            continue;
-        }
-        
-        QStringList parts;
-        if (line.contains(';')) {
-            parts = line.split(';');
-        } else if (line.contains(',')) {
-            parts = line.split(',');
-        } else if (line.contains('\t')) {
-            parts = line.split('\t');
-        } else {
-            parts = line.split(QRegularExpression("\\s+"));
-        }
-        
-        if (parts.size() >= 3) {
-            bool ok1, ok2, ok3;
-            int from = parts[0].trimmed().toInt(&ok1);
-            int to = parts[1].trimmed().toInt(&ok2);
-            double weight = parts[2].trimmed().toDouble(&ok3);
-            
-            if (ok1 && ok2 && ok3 && from >= 0 && to >= 0 && weight > 0) {
-                m_graph->addEdge(from, to, weight, true);
-                count++;
+        while (tokenizer.nextRecord()) {
+            if (tokenizer.fieldCount() >= 3) {
+                RouteRecord record;
+                bool ok1 = tokenizer.toInt(0, record.from);
+                bool ok2 = tokenizer.toInt(1, record.to);
+                bool ok3 = tokenizer.toDouble(2, record.weight);
+                
+                if (ok1 && ok2 && ok3 && record.from >= 0 && record.to >= 0 && record.weight > 0) {
+                    records.append(record);
+                }
             }
         }
+    });
+    
+    // Merge in file order so the graph matches a sequential load
+    int count = 0;
+    for (const QVector<RouteRecord>& records : chunks) {
+        for (const RouteRecord& record : records) {
+            m_graph->addEdge(record.from, record.to, record.weight, true);
+            count++;
+        }
     }
     
     file.close();
@@ -177,38 +290,20 @@ void FileController::loadClosures() {
         return;
     }
     
-    QFile file(getClosuresFilePath());
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    MappedFile file(getClosuresFilePath());
+    if (!file.open()) {
         emit closuresLoaded(0);
         return;
     }
     
-    QTextStream in(&file);
-    in.setEncoding(QStringConverter::Utf8);
+    LineTokenizer tokenizer(file.data(), file.size());
     int count = 0;
     
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        
-        if (line.isEmpty() || line.startsWith("#") || line.startsWith("//")) {
-            continue;
-        }
-        
-        QStringList parts;
-        if (line.contains(';')) {
-            parts = line.split(';');
-        } else if (line.contains(',')) {
-            parts = line.split(',');
-        } else if (line.contains('\t')) {
-            parts = line.split('\t');
-        } else {
-            parts = line.split(QRegularExpression("\\s+"));
-        }
-        
-        if (parts.size() >= 2) {
-            bool ok1, ok2;
-            int from = parts[0].trimmed().toInt(&ok1);
-            int to = parts[1].trimmed().toInt(&ok2);
+    while (tokenizer.nextRecord()) {
+        if (tokenizer.fieldCount() >= 2) {
+            int from, to;
+            bool ok1 = tokenizer.toInt(0, from);
+            bool ok2 = tokenizer.toInt(1, to);
             if (ok1 && ok2 && from >= 0 && to >= 0) {
                 m_graph->markEdgeClosed(from, to, true, true);
                 count++;
@@ -225,45 +320,100 @@ void FileController::loadReports() {
     m_reportManager->loadReports(getReportsFilePath());
 }
 
-void FileController::saveStations() {
+bool FileController::loadSnapshot() {
+    if (!m_tree || !m_graph) return false;
+    
+    QVector<Station> stations;
+    GraphSnapshot snapshot;
+    if (!BinarySnapshot::read(getSnapshotFilePath(), stations, snapshot)) return false;
+    
+    m_graph->restore(stations, snapshot);
+    m_tree->bulkLoad(stations);
+    
+    int closedCount = 0;
+    for (char closed : snapshot.closed()) {
+        if (closed) closedCount++;
+    }
+    
+    // The text files list each connection once; the snapshot holds both
+    // directions of it
+    emit stationsLoaded(stations.size());
+    emit routesLoaded(m_graph->getEdgeCount());
+    emit closuresLoaded(closedCount / 2);
+    return true;
+}
+
+bool FileController::saveSnapshot() {
+    if (!m_graph) return false;
+    
+    // Routes to unregistered stations only survive in rutas.txt, and the
+    // snapshot rebuilds the tree from the graph, so such a network or one
+    // whose tree and graph disagree is always loaded from text
+    if (m_graph->getAllEdges().size() != m_graph->getSnapshot().edgeCount() ||
+        (m_tree && m_tree->getSize() != m_graph->getStationCount())) {
+        QFile::remove(getSnapshotFilePath());
+        return false;
+    }
+    
+    QDir dir;
+    dir.mkpath(m_dataPath);
+    
+    if (!BinarySnapshot::write(getSnapshotFilePath(), *m_graph)) {
+        emit errorOccurred(QString("No se pudo escribir el archivo: %1").arg(getSnapshotFilePath()));
+        return false;
+    }
+    return true;
+}
+
+bool FileController::saveStations() {
     if (!m_tree) {
         emit errorOccurred("Tree no inicializado");
-        return;
+        return false;
     }
     
     QDir dir;
     dir.mkpath(m_dataPath);
     
-    QFile file(getStationsFilePath());
+    QSaveFile file(getStationsFilePath());
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
         emit errorOccurred("No se pudo guardar estaciones.txt");
-        return;
+        return false;
     }
     
     QTextStream out(&file);
     out.setEncoding(QStringConverter::Utf8);
-    out << "# Estaciones\n# Formato: ID;Nombre\n\n";
+    out << "# Estaciones\n# Formato: ID;Nombre[;X;Y]\n\n";
     
     QVector<Station> stations = m_tree->getAllStations();
     for (const Station& station : stations) {
-        out << station.getId() << ";" << station.getName() << "\n";
+        out << station.getId() << ";" << station.getName();
+        if (station.hasCoordinates()) {
+            out << ";" << QString::number(station.getX(), 'g', 12)
+                << ";" << QString::number(station.getY(), 'g', 12);
+        }
+        out << "\n";
     }
-    file.close();
+    out.flush();
+    if (!file.commit()) {
+        emit errorOccurred("No se pudo guardar estaciones.txt");
+        return false;
+    }
+    return true;
 }
 
-void FileController::saveRoutes() {
+bool FileController::saveRoutes() {
     if (!m_graph) {
         emit errorOccurred("Graph no inicializado");
-        return;
+        return false;
     }
     
     QDir dir;
     dir.mkpath(m_dataPath);
     
-    QFile file(getRoutesFilePath());
+    QSaveFile file(getRoutesFilePath());
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
         emit errorOccurred("No se pudo guardar rutas.txt");
-        return;
+        return false;
     }
     
     QTextStream out(&file);
@@ -280,22 +430,27 @@ void FileController::saveRoutes() {
             written.insert(key);
         }
     }
-    file.close();
+    out.flush();
+    if (!file.commit()) {
+        emit errorOccurred("No se pudo guardar rutas.txt");
+        return false;
+    }
+    return true;
 }
 
-void FileController::saveClosures() {
+bool FileController::saveClosures() {
     if (!m_graph) {
         emit errorOccurred("Graph no inicializado");
-        return;
+        return false;
     }
     
     QDir dir;
     dir.mkpath(m_dataPath);
     
-    QFile file(getClosuresFilePath());
+    QSaveFile file(getClosuresFilePath());
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
         emit errorOccurred("No se pudo guardar cierres.txt");
-        return;
+        return false;
     }
     
     QTextStream out(&file);
@@ -314,12 +469,21 @@ void FileController::saveClosures() {
             }
         }
     }
-    file.close();
+    out.flush();
+    if (!file.commit()) {
+        emit errorOccurred("No se pudo guardar cierres.txt");
+        return false;
+    }
+    return true;
 }
 
-void FileController::saveReports() {
-    if (!m_reportManager) return;
+bool FileController::saveReports() {
+    if (!m_reportManager) return true;
     QDir dir;
     dir.mkpath(m_dataPath);
-    m_reportManager->saveReports(getReportsFilePath());
+    if (!m_reportManager->saveReports(getReportsFilePath())) {
+        emit errorOccurred("No se pudo guardar reportes.txt");
+        return false;
+    }
+    return true;
 }
@@ -7,6 +7,7 @@
 class BinarySearchTree;
 class Graph;
 class ReportManager;
+class MutationJournal;
 
 class FileController : public QObject {
     Q_OBJECT
@@ -18,20 +19,24 @@ public:
     void setGraph(Graph* graph);
     void setReportManager(ReportManager* reportManager);
     void setDataPath(const QString& path);
+    void setJournal(MutationJournal* journal);
     
     ReportManager* getReportManager() const;
     
 public slots:
     bool loadAll();
     bool saveAll();
+    bool compact();
     void loadStations();
     void loadRoutes();
     void loadClosures();
     void loadReports();
-    void saveStations();
-    void saveRoutes();
-    void saveClosures();
-    void saveReports();
+    bool loadSnapshot();
+    bool saveStations();
+    bool saveRoutes();
+    bool saveClosures();
+    bool saveReports();
+    bool saveSnapshot();
     
 signals:
     void dataLoaded(bool success);
@@ -45,12 +50,17 @@ private:
     BinarySearchTree* m_tree;
     Graph* m_graph;
     ReportManager* m_reportManager;
+    MutationJournal* m_journal;
     QString m_dataPath;
     
     QString getStationsFilePath() const;
     QString getRoutesFilePath() const;
     QString getClosuresFilePath() const;
     QString getReportsFilePath() const;
+    QString getSnapshotFilePath() const;
+    QString getJournalFilePath() const;
+    bool isSnapshotCurrent() const;
+    int replayJournal(int generation);
 };
 
 #endif // FILECONTROLLER_H
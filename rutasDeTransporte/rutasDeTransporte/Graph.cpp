@@ -1,14 +1,34 @@
 #include "Graph.h"
 
-Graph::Graph() {}
+Graph::Graph() : m_snapshotValid(false), m_structureVersion(0), m_closureVersion(0) {}
 
 void Graph::addStation(const Station& station) {
+    invalidateSnapshot();
     m_stations[station.getId()] = station;
     if (!m_adjacencyList.contains(station.getId())) {
         m_adjacencyList[station.getId()] = QVector<Edge>();
     }
 }
 
+bool Graph::removeStation(int id) {
+    if (!m_stations.contains(id) && !m_adjacencyList.contains(id)) return false;
+    
+    invalidateSnapshot();
+    QVector<Edge> outgoing = m_adjacencyList.value(id);
+    for (const Edge& edge : outgoing) {
+        eraseEdge(id, edge.getTo());
+    }
+    QVector<int> incoming = m_incomingList.value(id);
+    for (int source : incoming) {
+        eraseEdge(source, id);
+    }
+    
+    m_stations.remove(id);
+    m_adjacencyList.remove(id);
+    m_incomingList.remove(id);
+    return true;
+}
+
 void Graph::addEdge(int from, int to, double weight, bool bidirectional) {
     if (!m_adjacencyList.contains(from)) {
         m_adjacencyList[from] = QVector<Edge>();
@@ -17,51 +37,23 @@ void Graph::addEdge(int from, int to, double weight, bool bidirectional) {
         m_adjacencyList[to] = QVector<Edge>();
     }
     
-    m_adjacencyList[from].append(Edge(from, to, weight));
+    insertEdge(from, to, weight);
     if (bidirectional) {
-        m_adjacencyList[to].append(Edge(to, from, weight));
+        insertEdge(to, from, weight);
     }
 }
 
 void Graph::removeEdge(int from, int to, bool bidirectional) {
-    if (m_adjacencyList.contains(from)) {
-        QVector<Edge>& edges = m_adjacencyList[from];
-        for (int i = 0; i < edges.size(); ++i) {
-            if (edges[i].getTo() == to) {
-                edges.removeAt(i);
-                break;
-            }
-        }
-    }
-    if (bidirectional && m_adjacencyList.contains(to)) {
-        QVector<Edge>& edges = m_adjacencyList[to];
-        for (int i = 0; i < edges.size(); ++i) {
-            if (edges[i].getTo() == from) {
-                edges.removeAt(i);
-                break;
-            }
-        }
+    eraseEdge(from, to);
+    if (bidirectional) {
+        eraseEdge(to, from);
     }
 }
 
 void Graph::markEdgeClosed(int from, int to, bool closed, bool bidirectional) {
-    if (m_adjacencyList.contains(from)) {
-        QVector<Edge>& edges = m_adjacencyList[from];
-        for (int i = 0; i < edges.size(); ++i) {
-            if (edges[i].getTo() == to) {
-                edges[i].setClosed(closed);
-                break;
-            }
-        }
-    }
-    if (bidirectional && m_adjacencyList.contains(to)) {
-        QVector<Edge>& edges = m_adjacencyList[to];
-        for (int i = 0; i < edges.size(); ++i) {
-            if (edges[i].getTo() == from) {
-                edges[i].setClosed(closed);
-                break;
-            }
-        }
+    setEdgeClosed(from, to, closed);
+    if (bidirectional) {
+        setEdgeClosed(to, from, closed);
     }
 }
 
@@ -89,6 +81,13 @@ QVector<Edge> Graph::getEdgesFrom(int stationId) const {
     return QVector<Edge>();
 }
 
+bool Graph::getEdge(int from, int to, Edge& result) const {
+    int slot = m_edgeIndex.find(from, to);
+    if (slot == -1) return false;
+    result = m_adjacencyList.constFind(from).value()[slot];
+    return true;
+}
+
 QVector<Edge> Graph::getAllEdges() const {
     QVector<Edge> result;
     for (auto it = m_adjacencyList.begin(); it != m_adjacencyList.end(); ++it) {
@@ -98,13 +97,8 @@ QVector<Edge> Graph::getAllEdges() const {
 }
 
 bool Graph::isEdgeClosed(int from, int to) const {
-    if (m_adjacencyList.contains(from)) {
-        const QVector<Edge>& edges = m_adjacencyList[from];
-        for (const Edge& edge : edges) {
-            if (edge.getTo() == to) return edge.isClosed();
-        }
-    }
-    return false;
+    int slot = m_edgeIndex.find(from, to);
+    return slot != -1 && m_adjacencyList.constFind(from).value()[slot].isClosed();
 }
 
 int Graph::getStationCount() const { return m_stations.size(); }
@@ -120,4 +114,128 @@ int Graph::getEdgeCount() const {
 void Graph::clear() {
     m_stations.clear();
     m_adjacencyList.clear();
+    m_incomingList.clear();
+    m_edgeIndex.clear();
+    invalidateSnapshot();
+}
+
+const GraphSnapshot& Graph::getSnapshot() const {
+    if (!m_snapshotValid) {
+        m_snapshot.build(m_stations, m_adjacencyList);
+        m_snapshotValid = true;
+    }
+    return m_snapshot;
+}
+
+void Graph::restore(const QVector<Station>& stations, const GraphSnapshot& snapshot) {
+    // stations must be listed in snapshot index order
+    clear();
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    m_edgeIndex.reserve(snapshot.edgeCount());
+    bool duplicates = false;
+    
+    for (int i = 0; i < stations.size(); ++i) {
+        int id = stations[i].getId();
+        m_stations.insert(id, stations[i]);
+        
+        QVector<Edge>& edges = m_adjacencyList[id];
+        edges.reserve(offsets[i + 1] - offsets[i]);
+        for (int e = offsets[i]; e < offsets[i + 1]; ++e) {
+            int to = snapshot.stationIdAt(targets[e]);
+            if (m_edgeIndex.find(id, to) != -1) {
+                duplicates = true;
+                continue;
+            }
+            Edge edge(id, to, weights[e]);
+            edge.setClosed(closed[e] != 0);
+            QVector<int>& sources = m_incomingList[to];
+            m_edgeIndex.insert(id, to, edges.size(), sources.size());
+            edges.append(edge);
+            sources.append(id);
+        }
+    }
+    
+    // A snapshot holding the same pair twice no longer matches the graph
+    if (!duplicates) {
+        m_snapshot = snapshot;
+        m_snapshotValid = true;
+    }
+}
+
+quint64 Graph::getStructureVersion() const { return m_structureVersion; }
+quint64 Graph::getClosureVersion() const { return m_closureVersion; }
+
+void Graph::invalidateSnapshot() {
+    m_structureVersion++;
+    if (m_snapshotValid) {
+        m_snapshot.clear();
+        m_snapshotValid = false;
+    }
+}
+
+void Graph::insertEdge(int from, int to, double weight) {
+    // A pair holds a single edge; adding it again only replaces the weight
+    int slot = m_edgeIndex.find(from, to);
+    if (slot != -1) {
+        m_adjacencyList[from][slot].setWeight(weight);
+        m_structureVersion++;
+        int edge = snapshotEdge(from, to, slot);
+        if (edge != -1) m_snapshot.setWeight(edge, weight);
+        return;
+    }
+    
+    invalidateSnapshot();
+    QVector<Edge>& edges = m_adjacencyList[from];
+    QVector<int>& sources = m_incomingList[to];
+    m_edgeIndex.insert(from, to, edges.size(), sources.size());
+    edges.append(Edge(from, to, weight));
+    sources.append(from);
+}
+
+void Graph::eraseEdge(int from, int to) {
+    int slot = m_edgeIndex.find(from, to);
+    if (slot == -1) return;
+    
+    // Move the last entry into each freed slot so removal stays O(1)
+    invalidateSnapshot();
+    QVector<Edge>& edges = m_adjacencyList[from];
+    int last = edges.size() - 1;
+    if (slot != last) {
+        edges[slot] = edges[last];
+        m_edgeIndex.setSlot(from, edges[slot].getTo(), slot);
+    }
+    edges.removeLast();
+    
+    int incomingSlot = m_edgeIndex.findIncoming(from, to);
+    QVector<int>& sources = m_incomingList[to];
+    last = sources.size() - 1;
+    if (incomingSlot != last) {
+        sources[incomingSlot] = sources[last];
+        m_edgeIndex.setIncomingSlot(sources[incomingSlot], to, incomingSlot);
+    }
+    sources.removeLast();
+    m_edgeIndex.remove(from, to);
+}
+
+void Graph::setEdgeClosed(int from, int to, bool closed) {
+    // Closures only flip a flag, so patch the snapshot instead of rebuilding it
+    int slot = m_edgeIndex.find(from, to);
+    if (slot == -1) return;
+    Edge& entry = m_adjacencyList[from][slot];
+    if (entry.isClosed() == closed) return;
+    entry.setClosed(closed);
+    m_closureVersion++;
+    int edge = snapshotEdge(from, to, slot);
+    if (edge != -1) m_snapshot.setClosed(edge, closed);
+}
+
+int Graph::snapshotEdge(int from, int to, int slot) const {
+    if (!m_snapshotValid) return -1;
+    int fromIndex = m_snapshot.indexOf(from);
+    int toIndex = m_snapshot.indexOf(to);
+    if (fromIndex == -1 || toIndex == -1) return -1;
+    return m_snapshot.edgeAt(fromIndex, slot, toIndex);
 }
@@ -3,6 +3,8 @@
 
 #include "Edge.h"
 #include "Station.h"
+#include "GraphSnapshot.h"
+#include "EdgeIndex.h"
 #include <QVector>
 #include <QMap>
 
@@ -11,6 +13,7 @@ public:
     Graph();
     
     void addStation(const Station& station);
+    bool removeStation(int id);
     void addEdge(int from, int to, double weight, bool bidirectional = true);
     void removeEdge(int from, int to, bool bidirectional = true);
     void markEdgeClosed(int from, int to, bool closed, bool bidirectional = true);
@@ -19,6 +22,7 @@ public:
     Station getStation(int id) const;
     QVector<Station> getAllStations() const;
     QVector<Edge> getEdgesFrom(int stationId) const;
+    bool getEdge(int from, int to, Edge& result) const;
     QVector<Edge> getAllEdges() const;
     bool isEdgeClosed(int from, int to) const;
     
@@ -26,9 +30,31 @@ public:
     int getEdgeCount() const;
     void clear();
     
+    const GraphSnapshot& getSnapshot() const;
+    quint64 getStructureVersion() const;
+    quint64 getClosureVersion() const;
+    void restore(const QVector<Station>& stations, const GraphSnapshot& snapshot);
+    
 private:
     QMap<int, Station> m_stations;
     QMap<int, QVector<Edge>> m_adjacencyList;
+    QMap<int, QVector<int>> m_incomingList;
+    EdgeIndex m_edgeIndex;
+    
+    mutable GraphSnapshot m_snapshot;
+    mutable bool m_snapshotValid;
+    
+    // Bumped on every change to stations, edges or weights, and on every
+    // closure flip, so derived results can tell when they are stale
+    quint64 m_structureVersion;
+    quint64 m_closureVersion;
+    
+    void insertEdge(int from, int to, double weight);
+    void eraseEdge(int from, int to);
+    void setEdgeClosed(int from, int to, bool closed);
+    
+    void invalidateSnapshot();
+    int snapshotEdge(int from, int to, int slot) const;
 };
 
 #endif // GRAPH_H
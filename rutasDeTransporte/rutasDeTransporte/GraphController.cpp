@@ -1,15 +1,22 @@
 #include "GraphController.h"
-#include <QQueue>
-#include <QStack>
-#include <QSet>
+#include "IndexedMinHeap.h"
+#include "MutationJournal.h"
+#include "ParallelFor.h"
+#include <QHash>
+#include <cmath>
 #include <limits>
 #include <algorithm>
+#include <chrono>
 
 GraphController::GraphController(Graph* graph, ReportManager* reportManager, QObject* parent) 
-    : QObject(parent), m_graph(graph), m_reportManager(reportManager) {
+    : QObject(parent), m_graph(graph), m_reportManager(reportManager), m_journal(nullptr),
+      m_heuristicScale(0.0), m_heuristicVersion(0), m_heuristicValid(false) {
+    m_workspaces.resize(ParallelFor::workerCount());
 }
 
 GraphController::~GraphController() {
+    if (m_hierarchyBuild.valid()) m_hierarchyBuild.wait();
+    if (m_hubLabelsBuild.valid()) m_hubLabelsBuild.wait();
 }
 
 Graph* GraphController::getGraph() {
@@ -20,6 +27,201 @@ ReportManager* GraphController::getReportManager() {
     return m_reportManager;
 }
 
+void GraphController::setJournal(MutationJournal* journal) {
+    m_journal = journal;
+}
+
+void GraphController::setCachePath(const QString& path) {
+    m_cachePath = path;
+}
+
+QVector<double> GraphController::hubLabelDistances(const QVector<QPair<int,int>>& queries) {
+    QVector<double> result(queries.size(), std::numeric_limits<double>::infinity());
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    double* distances = result.data();
+    
+    if (!prepareHubLabels()) {
+        dijkstraDistances(queries, distances);
+        return result;
+    }
+    
+    // Label merges only read shared state, so large batches are split over workers
+    const int chunkSize = 4096;
+    int chunks = (queries.size() + chunkSize - 1) / chunkSize;
+    ParallelFor::run(chunks, [&](int chunk, int) {
+        int end = qMin(static_cast<int>(queries.size()), (chunk + 1) * chunkSize);
+        for (int i = chunk * chunkSize; i < end; ++i) {
+            int originIdx = snapshot.indexOf(queries[i].first);
+            int destIdx = snapshot.indexOf(queries[i].second);
+            if (originIdx != -1 && destIdx != -1) {
+                distances[i] = m_hubLabels.distance(originIdx, destIdx);
+            }
+        }
+    });
+    
+    return result;
+}
+
+void GraphController::dijkstraDistances(const QVector<QPair<int,int>>& queries, double* distances) {
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    int n = snapshot.nodeCount();
+    
+    // Queries sharing an origin share one search, which stops once all of
+    // their destinations are settled
+    QHash<int, QVector<int>> byOrigin;
+    for (int i = 0; i < queries.size(); ++i) {
+        int originIdx = snapshot.indexOf(queries[i].first);
+        if (originIdx != -1 && snapshot.indexOf(queries[i].second) != -1) {
+            byOrigin[originIdx].append(i);
+        }
+    }
+    QVector<QVector<int>> groups;
+    groups.reserve(byOrigin.size());
+    for (auto it = byOrigin.constBegin(); it != byOrigin.constEnd(); ++it) {
+        groups.append(it.value());
+    }
+    
+    ParallelFor::run(groups.size(), [&](int task, int worker) {
+        const QVector<int>& group = groups[task];
+        int originIdx = snapshot.indexOf(queries[group.first()].first);
+        QVector<int> destinations;
+        destinations.reserve(group.size());
+        for (int i : group) destinations.append(snapshot.indexOf(queries[i].second));
+        std::sort(destinations.begin(), destinations.end());
+        destinations.erase(std::unique(destinations.begin(), destinations.end()), destinations.end());
+        
+        SearchWorkspace& search = workspace(worker);
+        IndexedMinHeap& heap = search.heap();
+        search.prepare(n);
+        search.setLabel(originIdx, 0.0, -1);
+        heap.push(originIdx, 0.0);
+        
+        int remaining = destinations.size();
+        while (!heap.isEmpty() && remaining > 0) {
+            int current = heap.popMin();
+            search.markVisited(current);
+            if (std::binary_search(destinations.begin(), destinations.end(), current)) remaining--;
+            
+            for (int e = offsets[current]; e < offsets[current + 1]; ++e) {
+                int next = targets[e];
+                if (closed[e] || search.isVisited(next)) continue;
+                
+                double newDistance = search.distance(current) + weights[e];
+                if (newDistance < search.distance(next)) {
+                    search.setLabel(next, newDistance, current);
+                    heap.pushOrDecrease(next, newDistance);
+                }
+            }
+        }
+        
+        // Unreached destinations keep their infinity
+        for (int i : group) {
+            int destIdx = snapshot.indexOf(queries[i].second);
+            if (search.isVisited(destIdx)) distances[i] = search.distance(destIdx);
+        }
+    });
+}
+
+QVector<double> GraphController::distanceMatrix(const QVector<int>& sources, const QVector<int>& targets) {
+    const double infinity = std::numeric_limits<double>::infinity();
+    int rows = sources.size();
+    int columns = targets.size();
+    QVector<double> matrix(qint64(rows) * columns, infinity);
+    if (rows == 0 || columns == 0) return matrix;
+    
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& edgeTargets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    int n = snapshot.nodeCount();
+    
+    // Unknown stations keep their row or column at infinity
+    QVector<int> targetIdx(columns);
+    QVector<char> isTarget(n, 0);
+    int distinctTargets = 0;
+    for (int c = 0; c < columns; ++c) {
+        targetIdx[c] = snapshot.indexOf(targets[c]);
+        if (targetIdx[c] != -1 && !isTarget[targetIdx[c]]) {
+            isTarget[targetIdx[c]] = 1;
+            distinctTargets++;
+        }
+    }
+    
+    // One Dijkstra per source, stopped as soon as every target is settled
+    double* output = matrix.data();
+    ParallelFor::run(rows, [&](int row, int worker) {
+        int sourceIdx = snapshot.indexOf(sources[row]);
+        if (sourceIdx == -1) return;
+        
+        SearchWorkspace& search = workspace(worker);
+        IndexedMinHeap& heap = search.heap();
+        search.prepare(n);
+        search.setLabel(sourceIdx, 0.0, -1);
+        heap.push(sourceIdx, 0.0);
+        
+        int remaining = distinctTargets;
+        while (!heap.isEmpty() && remaining > 0) {
+            int current = heap.popMin();
+            search.markVisited(current);
+            if (isTarget[current]) remaining--;
+            
+            for (int e = offsets[current]; e < offsets[current + 1]; ++e) {
+                int next = edgeTargets[e];
+                if (closed[e] || search.isVisited(next)) continue;
+                
+                double newDistance = search.distance(current) + weights[e];
+                if (newDistance < search.distance(next)) {
+                    search.setLabel(next, newDistance, current);
+                    heap.pushOrDecrease(next, newDistance);
+                }
+            }
+        }
+        
+        double* outputRow = output + qint64(row) * columns;
+        for (int c = 0; c < columns; ++c) {
+            if (targetIdx[c] != -1 && search.isVisited(targetIdx[c])) {
+                outputRow[c] = search.distance(targetIdx[c]);
+            }
+        }
+    });
+    
+    return matrix;
+}
+
+QVector<int> GraphController::hopDistances(int origin) {
+    QVector<int> hops;
+    if (!m_graph->hasStation(origin)) return hops;
+    
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    m_hopSearch.run(snapshot, snapshot.indexOf(origin));
+    return m_hopSearch.hopDistances();
+}
+
+bool GraphController::shortestPathTree(int origin, QVector<double>& distances, QVector<int>& parents) {
+    distances.clear();
+    parents.clear();
+    if (!m_graph->hasStation(origin)) return false;
+    
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    m_deltaStepping.run(snapshot, snapshot.indexOf(origin));
+    distances = m_deltaStepping.distances();
+    const QVector<int>& treeParents = m_deltaStepping.parents();
+    parents.resize(treeParents.size());
+    for (int i = 0; i < treeParents.size(); ++i) {
+        parents[i] = treeParents[i] == -1 ? -1 : snapshot.stationIdAt(treeParents[i]);
+    }
+    return true;
+}
+
+void GraphController::setBucketWidth(double width) {
+    m_deltaStepping.setBucketWidth(width);
+}
+
 void GraphController::loadMap() {
     QVector<Station> stations = m_graph->getAllStations();
     QVector<Edge> edges = m_graph->getAllEdges();
@@ -34,6 +236,9 @@ void GraphController::addEdge(int from, int to, double weight) {
             return;
         }
         m_graph->addEdge(from, to, weight, true);
+        if (m_journal && !m_journal->recordEdgeAdded(from, to, weight)) {
+            emit errorOccurred("El cambio no quedó guardado en el registro de cambios");
+        }
         emit connectionAdded(from, to, weight, true);
     } catch (...) {
         emit connectionAdded(from, to, weight, false);
@@ -44,6 +249,9 @@ void GraphController::addEdge(int from, int to, double weight) {
 void GraphController::removeEdge(int from, int to) {
     try {
         m_graph->removeEdge(from, to, true);
+        if (m_journal && !m_journal->recordEdgeRemoved(from, to)) {
+            emit errorOccurred("El cambio no quedó guardado en el registro de cambios");
+        }
         emit connectionRemoved(from, to, true);
     } catch (...) {
         emit connectionRemoved(from, to, false);
@@ -54,12 +262,52 @@ void GraphController::removeEdge(int from, int to) {
 void GraphController::markEdgeClosed(int from, int to) {
     try {
         m_graph->markEdgeClosed(from, to, true, true);
+        m_dynamicPaths.edgeChanged(*m_graph, from, to);
+        m_dynamicPaths.edgeChanged(*m_graph, to, from);
+        if (m_journal && !m_journal->recordClosure(from, to, true)) {
+            emit errorOccurred("El cambio no quedó guardado en el registro de cambios");
+        }
         emit closureMarked(from, to, true);
     } catch (...) {
         emit errorOccurred("Error al marcar cierre");
     }
 }
 
+void GraphController::reopenEdge(int from, int to) {
+    try {
+        m_graph->markEdgeClosed(from, to, false, true);
+        m_dynamicPaths.edgeChanged(*m_graph, from, to);
+        m_dynamicPaths.edgeChanged(*m_graph, to, from);
+        if (m_journal && !m_journal->recordClosure(from, to, false)) {
+            emit errorOccurred("El cambio no quedó guardado en el registro de cambios");
+        }
+        emit closureMarked(from, to, false);
+    } catch (...) {
+        emit errorOccurred("Error al reabrir ruta");
+    }
+}
+
+void GraphController::registerHub(int stationId) {
+    try {
+        if (!m_graph->hasStation(stationId)) {
+            emit hubRegistered(stationId, false);
+            return;
+        }
+        m_dynamicPaths.addHub(stationId);
+        emit hubRegistered(stationId, true);
+    } catch (...) {
+        emit errorOccurred("Error al registrar estación central");
+    }
+}
+
+void GraphController::unregisterHub(int stationId) {
+    try {
+        m_dynamicPaths.removeHub(stationId);
+    } catch (...) {
+        emit errorOccurred("Error al quitar estación central");
+    }
+}
+
 void GraphController::runBFS(int origin, int destination) {
     try {
         QVector<int> path = bfsSearch(origin, destination);
@@ -105,6 +353,115 @@ void GraphController::runDijkstra(int origin, int destination) {
     }
 }
 
+void GraphController::runIntegerDijkstra(int origin, int destination) {
+    try {
+        double cost = 0.0;
+        QVector<int> path = integerDijkstraSearch(origin, destination, cost);
+        if (path.isEmpty()) {
+            emit pathNotFound("Dijkstra (metros)");
+        } else {
+            emit pathFound("Dijkstra (metros)", path, cost);
+            addReportEntry("Dijkstra (metros)", origin, destination, path, cost);
+        }
+    } catch (...) {
+        emit errorOccurred("Error al ejecutar Dijkstra en metros");
+    }
+}
+
+void GraphController::runKShortest(int origin, int destination, int k) {
+    try {
+        QVector<QVector<int>> paths;
+        QVector<double> costs;
+        kShortestSearch(origin, destination, k, paths, costs);
+        if (paths.isEmpty()) {
+            emit pathNotFound("K rutas alternativas");
+        } else {
+            emit kPathsFound(paths, costs);
+            addReportEntry("K rutas alternativas", origin, destination, paths.first(), costs.first(),
+                           paths.mid(1), costs.mid(1));
+        }
+    } catch (...) {
+        emit errorOccurred("Error al buscar rutas alternativas");
+    }
+}
+
+void GraphController::runAStar(int origin, int destination) {
+    try {
+        double cost = 0.0;
+        QVector<int> path = aStarSearch(origin, destination, cost);
+        if (path.isEmpty()) {
+            emit pathNotFound("A*");
+        } else {
+            emit pathFound("A*", path, cost);
+            addReportEntry("A*", origin, destination, path, cost);
+        }
+    } catch (...) {
+        emit errorOccurred("Error al ejecutar A*");
+    }
+}
+
+void GraphController::runBidirectionalDijkstra(int origin, int destination) {
+    try {
+        double cost = 0.0;
+        QVector<int> path = bidirectionalDijkstraSearch(origin, destination, cost);
+        if (path.isEmpty()) {
+            emit pathNotFound("Dijkstra bidireccional");
+        } else {
+            emit pathFound("Dijkstra bidireccional", path, cost);
+            addReportEntry("Dijkstra bidireccional", origin, destination, path, cost);
+        }
+    } catch (...) {
+        emit errorOccurred("Error al ejecutar Dijkstra bidireccional");
+    }
+}
+
+void GraphController::runContractionHierarchy(int origin, int destination) {
+    try {
+        double cost = 0.0;
+        QString algorithm;
+        QVector<int> path = contractionHierarchySearch(origin, destination, cost, algorithm);
+        if (path.isEmpty()) {
+            emit pathNotFound(algorithm);
+        } else {
+            emit pathFound(algorithm, path, cost);
+            addReportEntry(algorithm, origin, destination, path, cost);
+        }
+    } catch (...) {
+        emit errorOccurred("Error al ejecutar Jerarquías de contracción");
+    }
+}
+
+void GraphController::runLandmarkAStar(int origin, int destination) {
+    try {
+        double cost = 0.0;
+        QVector<int> path = landmarkSearch(origin, destination, cost);
+        if (path.isEmpty()) {
+            emit pathNotFound("A* con landmarks");
+        } else {
+            emit pathFound("A* con landmarks", path, cost);
+            addReportEntry("A* con landmarks", origin, destination, path, cost);
+        }
+    } catch (...) {
+        emit errorOccurred("Error al ejecutar A* con landmarks");
+    }
+}
+
+void GraphController::runHubLabels(int origin, int destination) {
+    try {
+        double cost = 0.0;
+        QString algorithm;
+        QVector<int> path = hubLabelSearch(origin, destination, cost, algorithm);
+        if (path.isEmpty()) {
+            emit pathNotFound(algorithm);
+        } else {
+            emit pathFound(algorithm, path, cost);
+            addReportEntry(algorithm, origin, destination, path, cost);
+        }
+    } catch (...) {
+        emit errorOccurred("Error al ejecutar Etiquetas de hubs");
+    }
+}
+
 void GraphController::runFloydWarshall(int origin, int destination) {
     try {
         double cost = 0.0;
@@ -167,7 +524,9 @@ void GraphController::generateReport() {
 }
 
 void GraphController::addReportEntry(const QString& algorithm, int origin, int destination,
-                                     const QVector<int>& path, double cost) {
+                                     const QVector<int>& path, double cost,
+                                     const QVector<QVector<int>>& alternatives,
+                                     const QVector<double>& alternativeCosts) {
     ReportManager::ReportEntry entry;
     entry.timestamp = QDateTime::currentDateTime();
     entry.algorithm = algorithm;
@@ -191,57 +550,50 @@ void GraphController::addReportEntry(const QString& algorithm, int origin, int d
         }
     }
     
+    for (int i = 0; i < alternatives.size(); ++i) {
+        ReportManager::Alternative alternative;
+        alternative.path = alternatives[i];
+        alternative.totalCost = alternativeCosts[i];
+        for (int id : alternatives[i]) {
+            alternative.pathNames.append(m_graph->hasStation(id) ? m_graph->getStation(id).getName() : QString());
+        }
+        entry.alternatives.append(alternative);
+    }
+    
     m_reportManager->addReport(entry);
+    if (m_journal && !m_journal->recordReport(entry)) {
+        emit errorOccurred("El cambio no quedó guardado en el registro de cambios");
+    }
 }
 
 double GraphController::calculatePathCost(const QVector<int>& path) {
     double totalCost = 0.0;
     for (int i = 0; i < path.size() - 1; ++i) {
-        QVector<Edge> edges = m_graph->getEdgesFrom(path[i]);
-        for (const Edge& edge : edges) {
-            if (edge.getTo() == path[i + 1]) {
-                totalCost += edge.getWeight();
-                break;
-            }
+        Edge edge;
+        if (m_graph->getEdge(path[i], path[i + 1], edge)) {
+            totalCost += edge.getWeight();
         }
     }
     return totalCost;
 }
 
+SearchWorkspace& GraphController::workspace(int worker) {
+    return m_workspaces[worker];
+}
+
 QVector<int> GraphController::bfsSearch(int origin, int destination) {
     QVector<int> path;
     if (!m_graph->hasStation(origin) || !m_graph->hasStation(destination)) {
         return path;
     }
     
-    QQueue<int> queue;
-    QSet<int> visited;
-    QMap<int, int> parent;
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    int originIdx = snapshot.indexOf(origin);
+    int destIdx = snapshot.indexOf(destination);
     
-    queue.enqueue(origin);
-    visited.insert(origin);
-    parent[origin] = -1;
-    
-    while (!queue.isEmpty()) {
-        int current = queue.dequeue();
-        
-        if (current == destination) {
-            int node = destination;
-            while (node != -1) {
-                path.prepend(node);
-                node = parent[node];
-            }
-            return path;
-        }
-        
-        QVector<Edge> edges = m_graph->getEdgesFrom(current);
-        for (const Edge& edge : edges) {
-            if (!edge.isClosed() && !visited.contains(edge.getTo())) {
-                visited.insert(edge.getTo());
-                parent[edge.getTo()] = current;
-                queue.enqueue(edge.getTo());
-            }
-        }
+    m_hopSearch.run(snapshot, originIdx, destIdx);
+    for (int index : m_hopSearch.path(snapshot, originIdx, destIdx)) {
+        path.append(snapshot.stationIdAt(index));
     }
     
     return path;
@@ -253,35 +605,40 @@ QVector<int> GraphController::dfsSearch(int origin, int destination) {
         return path;
     }
     
-    QStack<int> stack;
-    QSet<int> visited;
-    QMap<int, int> parent;
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<char>& closed = snapshot.closed();
+    int n = snapshot.nodeCount();
+    int originIdx = snapshot.indexOf(origin);
+    int destIdx = snapshot.indexOf(destination);
     
-    stack.push(origin);
-    parent[origin] = -1;
+    // A node keeps the parent that first pushed it; the frontier is the stack
+    SearchWorkspace& search = workspace();
+    QVector<int>& stack = search.frontier();
+    search.prepare(n);
+    
+    stack.append(originIdx);
+    search.setLabel(originIdx, 0.0, -1);
     
     while (!stack.isEmpty()) {
-        int current = stack.pop();
+        int current = stack.takeLast();
         
-        if (visited.contains(current)) continue;
-        visited.insert(current);
+        if (search.isVisited(current)) continue;
+        search.markVisited(current);
         
-        if (current == destination) {
-            int node = destination;
-            while (node != -1) {
-                path.prepend(node);
-                node = parent[node];
-            }
+        if (current == destIdx) {
+            search.tracePath(snapshot, destIdx, path);
             return path;
         }
         
-        QVector<Edge> edges = m_graph->getEdgesFrom(current);
-        for (const Edge& edge : edges) {
-            if (!edge.isClosed() && !visited.contains(edge.getTo())) {
-                if (!parent.contains(edge.getTo())) {
-                    parent[edge.getTo()] = current;
+        for (int e = offsets[current]; e < offsets[current + 1]; ++e) {
+            int next = targets[e];
+            if (!closed[e] && !search.isVisited(next)) {
+                if (!search.isReached(next)) {
+                    search.setLabel(next, 0.0, current);
                 }
-                stack.push(edge.getTo());
+                stack.append(next);
             }
         }
     }
@@ -297,63 +654,201 @@ QVector<int> GraphController::dijkstraSearch(int origin, int destination, double
         return path;
     }
     
-    QMap<int, double> distances;
-    QMap<int, int> parent;
-    QSet<int> visited;
-    
-    QVector<Station> allStations = m_graph->getAllStations();
-    for (const Station& station : allStations) {
-        distances[station.getId()] = std::numeric_limits<double>::infinity();
+    // Hubs keep a full shortest-path tree that closures repair in place
+    if (m_dynamicPaths.isHub(origin)) {
+        if (!m_dynamicPaths.isCurrent(*m_graph)) m_dynamicPaths.rebuild(*m_graph);
+        const GraphSnapshot& snapshot = m_graph->getSnapshot();
+        int destIdx = snapshot.indexOf(destination);
+        for (int index : m_dynamicPaths.path(origin, destIdx)) {
+            path.append(snapshot.stationIdAt(index));
+        }
+        if (!path.isEmpty()) cost = m_dynamicPaths.distance(origin, destIdx);
+        return path;
     }
-    distances[origin] = 0.0;
-    parent[origin] = -1;
     
-    while (true) {
-        int current = -1;
-        double minDistance = std::numeric_limits<double>::infinity();
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    int n = snapshot.nodeCount();
+    
+    SearchWorkspace& search = workspace();
+    IndexedMinHeap& heap = search.heap();
+    search.prepare(n);
+    
+    int originIdx = snapshot.indexOf(origin);
+    int destIdx = snapshot.indexOf(destination);
+    search.setLabel(originIdx, 0.0, -1);
+    heap.push(originIdx, 0.0);
+    
+    while (!heap.isEmpty()) {
+        int current = heap.popMin();
+        search.markVisited(current);
+        
+        if (current == destIdx) {
+            break;
+        }
         
-        for (auto it = distances.begin(); it != distances.end(); ++it) {
-            if (!visited.contains(it.key()) && it.value() < minDistance) {
-                minDistance = it.value();
-                current = it.key();
+        for (int e = offsets[current]; e < offsets[current + 1]; ++e) {
+            int next = targets[e];
+            if (closed[e] || search.isVisited(next)) continue;
+            
+            double newDistance = search.distance(current) + weights[e];
+            if (newDistance < search.distance(next)) {
+                search.setLabel(next, newDistance, current);
+                heap.pushOrDecrease(next, newDistance);
             }
         }
+    }
+    
+    if (search.isVisited(destIdx)) {
+        search.tracePath(snapshot, destIdx, path);
+        cost = search.distance(destIdx);
+    }
+    
+    return path;
+}
+
+QVector<int> GraphController::integerDijkstraSearch(int origin, int destination, double& cost) {
+    QVector<int> path;
+    cost = 0.0;
+    
+    if (!m_graph->hasStation(origin) || !m_graph->hasStation(destination)) {
+        return path;
+    }
+    
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<quint32>& metres = snapshot.metres();
+    const QVector<char>& closed = snapshot.closed();
+    int n = snapshot.nodeCount();
+    
+    // Metre sums stay exact in a double well past any real network, so the
+    // workspace labels hold them unchanged
+    SearchWorkspace& search = workspace();
+    RadixHeap& heap = search.radixHeap();
+    search.prepare(n);
+    
+    int originIdx = snapshot.indexOf(origin);
+    int destIdx = snapshot.indexOf(destination);
+    search.setLabel(originIdx, 0.0, -1);
+    heap.push(originIdx, 0);
+    
+    while (!heap.isEmpty()) {
+        int current = heap.popMin();
+        // Stations are pushed again instead of decreased; later copies are stale
+        if (search.isVisited(current)) continue;
+        search.markVisited(current);
         
-        if (current == -1 || minDistance == std::numeric_limits<double>::infinity()) {
+        if (current == destIdx) {
             break;
         }
         
-        visited.insert(current);
+        quint64 distance = heap.lastKey();
+        for (int e = offsets[current]; e < offsets[current + 1]; ++e) {
+            int next = targets[e];
+            if (closed[e] || search.isVisited(next)) continue;
+            
+            quint64 newDistance = distance + metres[e];
+            if (double(newDistance) < search.distance(next)) {
+                search.setLabel(next, double(newDistance), current);
+                heap.push(next, newDistance);
+            }
+        }
+    }
+    
+    if (search.isVisited(destIdx)) {
+        search.tracePath(snapshot, destIdx, path);
+        cost = search.distance(destIdx) / 1000.0;
+    }
+    
+    return path;
+}
+
+void GraphController::kShortestSearch(int origin, int destination, int k,
+                                      QVector<QVector<int>>& paths, QVector<double>& costs) {
+    paths.clear();
+    costs.clear();
+    
+    if (!m_graph->hasStation(origin) || !m_graph->hasStation(destination)) {
+        return;
+    }
+    
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    m_kShortest.run(snapshot, workspace(), snapshot.indexOf(origin), snapshot.indexOf(destination), k);
+    for (int i = 0; i < m_kShortest.pathCount(); ++i) {
+        QVector<int> path;
+        for (int index : m_kShortest.path(i)) {
+            path.append(snapshot.stationIdAt(index));
+        }
+        paths.append(path);
+        costs.append(m_kShortest.cost(i));
+    }
+}
+
+QVector<int> GraphController::aStarSearch(int origin, int destination, double& cost) {
+    QVector<int> path;
+    cost = 0.0;
+    
+    if (!m_graph->hasStation(origin) || !m_graph->hasStation(destination)) {
+        return path;
+    }
+    
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    int n = snapshot.nodeCount();
+    prepareHeuristic();
+    
+    int originIdx = snapshot.indexOf(origin);
+    int destIdx = snapshot.indexOf(destination);
+    double destX = m_stationX[destIdx];
+    double destY = m_stationY[destIdx];
+    auto heuristic = [&](int node) {
+        return m_heuristicScale * std::hypot(m_stationX[node] - destX, m_stationY[node] - destY);
+    };
+    
+    SearchWorkspace& search = workspace();
+    IndexedMinHeap& heap = search.heap();
+    search.prepare(n);
+    
+    search.setLabel(originIdx, 0.0, -1);
+    heap.push(originIdx, heuristic(originIdx));
+    
+    // The heuristic is consistent, so every node is settled at most once
+    while (!heap.isEmpty()) {
+        int current = heap.popMin();
+        search.markVisited(current);
         
-        if (current == destination) {
+        if (current == destIdx) {
             break;
         }
         
-        QVector<Edge> edges = m_graph->getEdgesFrom(current);
-        for (const Edge& edge : edges) {
-            if (!edge.isClosed() && !visited.contains(edge.getTo())) {
-                double newDistance = distances[current] + edge.getWeight();
-                if (newDistance < distances[edge.getTo()]) {
-                    distances[edge.getTo()] = newDistance;
-                    parent[edge.getTo()] = current;
-                }
+        for (int e = offsets[current]; e < offsets[current + 1]; ++e) {
+            int next = targets[e];
+            if (closed[e] || search.isVisited(next)) continue;
+            
+            double newDistance = search.distance(current) + weights[e];
+            if (newDistance < search.distance(next)) {
+                search.setLabel(next, newDistance, current);
+                heap.pushOrDecrease(next, newDistance + heuristic(next));
             }
         }
     }
     
-    if (visited.contains(destination) && distances[destination] != std::numeric_limits<double>::infinity()) {
-        int node = destination;
-        while (node != -1) {
-            path.prepend(node);
-            node = parent[node];
-        }
-        cost = distances[destination];
+    if (search.isVisited(destIdx)) {
+        search.tracePath(snapshot, destIdx, path);
+        cost = search.distance(destIdx);
     }
     
     return path;
 }
 
-QVector<int> GraphController::floydWarshallSearch(int origin, int destination, double& cost) {
+QVector<int> GraphController::bidirectionalDijkstraSearch(int origin, int destination, double& cost) {
     QVector<int> path;
     cost = 0.0;
     
@@ -361,59 +856,379 @@ QVector<int> GraphController::floydWarshallSearch(int origin, int destination, d
         return path;
     }
     
-    QVector<Station> stations = m_graph->getAllStations();
-    int n = stations.size();
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    const QVector<int>& reverseOffsets = snapshot.reverseOffsets();
+    const QVector<int>& reverseSources = snapshot.reverseSources();
+    const QVector<int>& reverseEdges = snapshot.reverseEdges();
+    int n = snapshot.nodeCount();
     
-    QMap<int, int> stationToIndex;
-    QMap<int, int> indexToStation;
-    for (int i = 0; i < n; ++i) {
-        stationToIndex[stations[i].getId()] = i;
-        indexToStation[i] = stations[i].getId();
+    int originIdx = snapshot.indexOf(origin);
+    int destIdx = snapshot.indexOf(destination);
+    if (originIdx == destIdx) {
+        path.append(origin);
+        return path;
+    }
+    
+    // Both directions keep their labels in reusable workspaces, so a query
+    // only touches the stations it reaches
+    const double infinity = std::numeric_limits<double>::infinity();
+    SearchWorkspace& forward = workspace();
+    SearchWorkspace& backward = m_backwardWorkspace;
+    IndexedMinHeap& forwardHeap = forward.heap();
+    IndexedMinHeap& backwardHeap = backward.heap();
+    forward.prepare(n);
+    backward.prepare(n);
+    
+    forward.setLabel(originIdx, 0.0, -1);
+    backward.setLabel(destIdx, 0.0, -1);
+    forwardHeap.push(originIdx, 0.0);
+    backwardHeap.push(destIdx, 0.0);
+    
+    // Best origin-destination cost seen so far, through the edge meetFrom -> meetTo
+    double best = infinity;
+    int meetFrom = -1;
+    int meetTo = -1;
+    
+    while (!forwardHeap.isEmpty() && !backwardHeap.isEmpty()) {
+        double forwardTop = forwardHeap.topKey();
+        double backwardTop = backwardHeap.topKey();
+        // No path left to discover can be shorter than the two frontiers combined
+        if (forwardTop + backwardTop >= best) {
+            break;
+        }
+        
+        if (forwardTop <= backwardTop) {
+            int current = forwardHeap.popMin();
+            forward.markVisited(current);
+            
+            for (int e = offsets[current]; e < offsets[current + 1]; ++e) {
+                if (closed[e]) continue;
+                int next = targets[e];
+                double newDistance = forward.distance(current) + weights[e];
+                
+                // Checked before the visited test so every edge joining both
+                // searches is considered at least once
+                if (newDistance + backward.distance(next) < best) {
+                    best = newDistance + backward.distance(next);
+                    meetFrom = current;
+                    meetTo = next;
+                }
+                
+                if (forward.isVisited(next)) continue;
+                if (newDistance < forward.distance(next)) {
+                    forward.setLabel(next, newDistance, current);
+                    forwardHeap.pushOrDecrease(next, newDistance);
+                }
+            }
+        } else {
+            int current = backwardHeap.popMin();
+            backward.markVisited(current);
+            
+            for (int r = reverseOffsets[current]; r < reverseOffsets[current + 1]; ++r) {
+                int e = reverseEdges[r];
+                if (closed[e]) continue;
+                int previous = reverseSources[r];
+                double newDistance = backward.distance(current) + weights[e];
+                
+                if (forward.distance(previous) + newDistance < best) {
+                    best = forward.distance(previous) + newDistance;
+                    meetFrom = previous;
+                    meetTo = current;
+                }
+                
+                if (backward.isVisited(previous)) continue;
+                if (newDistance < backward.distance(previous)) {
+                    backward.setLabel(previous, newDistance, current);
+                    backwardHeap.pushOrDecrease(previous, newDistance);
+                }
+            }
+        }
+    }
+    
+    if (meetFrom != -1) {
+        for (int node = meetFrom; node != -1; node = forward.parent(node)) {
+            path.append(snapshot.stationIdAt(node));
+        }
+        std::reverse(path.begin(), path.end());
+        for (int node = meetTo; node != -1; node = backward.parent(node)) {
+            path.append(snapshot.stationIdAt(node));
+        }
+        cost = best;
     }
     
-    QVector<QVector<double>> dist(n, QVector<double>(n, std::numeric_limits<double>::infinity()));
-    QVector<QVector<int>> next(n, QVector<int>(n, -1));
+    return path;
+}
+
+void GraphController::prepareHeuristic() {
+    if (m_heuristicValid && m_heuristicVersion == m_graph->getStructureVersion()) return;
+    
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    int n = snapshot.nodeCount();
     
+    m_stationX.fill(0.0, n);
+    m_stationY.fill(0.0, n);
+    bool complete = true;
+    QVector<Station> stations = m_graph->getAllStations();
     for (int i = 0; i < n; ++i) {
-        dist[i][i] = 0.0;
+        if (!stations[i].hasCoordinates()) {
+            complete = false;
+            break;
+        }
+        m_stationX[i] = stations[i].getX();
+        m_stationY[i] = stations[i].getY();
     }
     
-    for (const Station& station : stations) {
-        int fromIdx = stationToIndex[station.getId()];
-        QVector<Edge> edges = m_graph->getEdgesFrom(station.getId());
-        for (const Edge& edge : edges) {
-            if (!edge.isClosed() && stationToIndex.contains(edge.getTo())) {
-                int toIdx = stationToIndex[edge.getTo()];
-                dist[fromIdx][toIdx] = edge.getWeight();
-                next[fromIdx][toIdx] = toIdx;
+    // Scale straight-line distance by the smallest km-per-unit ratio of any
+    // edge, closed ones included, so it never overestimates the remaining
+    // cost. Without coordinates for every station A* degrades to Dijkstra.
+    m_heuristicScale = 0.0;
+    if (complete) {
+        double scale = std::numeric_limits<double>::infinity();
+        for (int from = 0; from < n; ++from) {
+            for (int e = offsets[from]; e < offsets[from + 1]; ++e) {
+                double length = std::hypot(m_stationX[from] - m_stationX[targets[e]],
+                                           m_stationY[from] - m_stationY[targets[e]]);
+                if (length > 0.0) scale = qMin(scale, weights[e] / length);
             }
         }
+        if (scale != std::numeric_limits<double>::infinity()) m_heuristicScale = scale;
     }
     
-    for (int k = 0; k < n; ++k) {
-        for (int i = 0; i < n; ++i) {
-            for (int j = 0; j < n; ++j) {
-                if (dist[i][k] != std::numeric_limits<double>::infinity() &&
-                    dist[k][j] != std::numeric_limits<double>::infinity() &&
-                    dist[i][k] + dist[k][j] < dist[i][j]) {
-                    dist[i][j] = dist[i][k] + dist[k][j];
-                    next[i][j] = next[i][k];
-                }
+    m_heuristicVersion = m_graph->getStructureVersion();
+    m_heuristicValid = true;
+}
+
+QVector<int> GraphController::contractionHierarchySearch(int origin, int destination, double& cost, QString& algorithm) {
+    QVector<int> path;
+    cost = 0.0;
+    algorithm = "Jerarquías de contracción";
+    
+    if (!m_graph->hasStation(origin) || !m_graph->hasStation(destination)) {
+        return path;
+    }
+    
+    // Closures happen all the time and each one outdates the hierarchy;
+    // until the background rebuild catches up, ALT answers instead, under
+    // its own name so reports do not credit the hierarchy
+    if (!prepareHierarchy()) {
+        if (m_landmarks.isCurrent(*m_graph)) {
+            algorithm = "Jerarquías de contracción (A* con landmarks mientras se reconstruye)";
+            return landmarkSearch(origin, destination, cost);
+        }
+        algorithm = "Jerarquías de contracción (Dijkstra mientras se reconstruye)";
+        return dijkstraSearch(origin, destination, cost);
+    }
+    
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    QVector<int> indices;
+    double distance = m_hierarchy.query(snapshot.indexOf(origin), snapshot.indexOf(destination), indices);
+    for (int index : indices) {
+        path.append(snapshot.stationIdAt(index));
+    }
+    if (!path.isEmpty()) {
+        cost = distance;
+    }
+    
+    return path;
+}
+
+QVector<int> GraphController::landmarkSearch(int origin, int destination, double& cost) {
+    QVector<int> path;
+    cost = 0.0;
+    
+    if (!m_graph->hasStation(origin) || !m_graph->hasStation(destination)) {
+        return path;
+    }
+    
+    // Closures keep the landmark bounds valid, so only structure changes rebuild them
+    if (!m_landmarks.isCurrent(*m_graph)) {
+        m_landmarks.build(*m_graph);
+    }
+    
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    int n = snapshot.nodeCount();
+    const double infinity = std::numeric_limits<double>::infinity();
+    
+    int originIdx = snapshot.indexOf(origin);
+    int destIdx = snapshot.indexOf(destination);
+    if (m_landmarks.lowerBound(originIdx, destIdx) == infinity) {
+        return path;
+    }
+    
+    SearchWorkspace& search = workspace();
+    IndexedMinHeap& heap = search.heap();
+    search.prepare(n);
+    
+    search.setLabel(originIdx, 0.0, -1);
+    heap.push(originIdx, m_landmarks.lowerBound(originIdx, destIdx));
+    
+    while (!heap.isEmpty()) {
+        int current = heap.popMin();
+        search.markVisited(current);
+        
+        if (current == destIdx) {
+            break;
+        }
+        
+        for (int e = offsets[current]; e < offsets[current + 1]; ++e) {
+            int next = targets[e];
+            if (closed[e] || search.isVisited(next)) continue;
+            
+            double newDistance = search.distance(current) + weights[e];
+            if (newDistance < search.distance(next)) {
+                // Stations the landmarks prove cannot reach the destination are never queued
+                double bound = m_landmarks.lowerBound(next, destIdx);
+                if (bound == infinity) continue;
+                search.setLabel(next, newDistance, current);
+                heap.pushOrDecrease(next, newDistance + bound);
             }
         }
     }
     
-    int originIdx = stationToIndex[origin];
-    int destIdx = stationToIndex[destination];
+    if (search.isVisited(destIdx)) {
+        search.tracePath(snapshot, destIdx, path);
+        cost = search.distance(destIdx);
+    }
     
-    if (next[originIdx][destIdx] != -1) {
-        path.append(origin);
-        int current = originIdx;
-        while (current != destIdx) {
-            current = next[current][destIdx];
-            path.append(indexToStation[current]);
+    return path;
+}
+
+QVector<int> GraphController::hubLabelSearch(int origin, int destination, double& cost, QString& algorithm) {
+    QVector<int> path;
+    cost = 0.0;
+    algorithm = "Etiquetas de hubs";
+    
+    if (!m_graph->hasStation(origin) || !m_graph->hasStation(destination)) {
+        return path;
+    }
+    
+    // Labels outdated by a closure are rebuilt in the background; Dijkstra
+    // answers in the meantime
+    if (!prepareHubLabels()) {
+        algorithm = "Etiquetas de hubs (Dijkstra mientras se reconstruye)";
+        return dijkstraSearch(origin, destination, cost);
+    }
+    
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    int originIdx = snapshot.indexOf(origin);
+    int destIdx = snapshot.indexOf(destination);
+    double distance = m_hubLabels.distance(originIdx, destIdx);
+    if (distance == std::numeric_limits<double>::infinity()) {
+        return path;
+    }
+    
+    // Path recovery can only fail on zero-weight cycles; Dijkstra settles those
+    QVector<int> indices = m_hubLabels.path(snapshot, originIdx, destIdx);
+    if (indices.isEmpty()) {
+        return dijkstraSearch(origin, destination, cost);
+    }
+    for (int index : indices) {
+        path.append(snapshot.stationIdAt(index));
+    }
+    cost = distance;
+    
+    return path;
+}
+
+bool GraphController::prepareHierarchy() {
+    if (m_hierarchy.isCurrent(*m_graph)) return true;
+    
+    // A finished build may already be outdated again, in which case the
+    // next one starts from the current network
+    if (m_hierarchyBuild.valid() &&
+        m_hierarchyBuild.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        try {
+            std::unique_ptr<ContractionHierarchy> built = m_hierarchyBuild.get();
+            m_hierarchy = std::move(*built);
+        } catch (...) {
+            emit errorOccurred("Error al construir las jerarquías de contracción");
+        }
+        if (m_hierarchy.isCurrent(*m_graph)) return true;
+    }
+    
+    if (!m_hierarchyBuild.valid()) {
+        // Loading a cache file that matches this network is cheap next to
+        // contracting it, so it happens right away instead of in the worker
+        if (!m_cachePath.isEmpty() && m_hierarchy.load(m_cachePath, *m_graph)) return true;
+        
+        // The worker gets its own copy of the snapshot, so the graph stays
+        // free to change
+        GraphSnapshot snapshot = m_graph->getSnapshot();
+        quint64 structureVersion = m_graph->getStructureVersion();
+        quint64 closureVersion = m_graph->getClosureVersion();
+        QString cachePath = m_cachePath;
+        m_hierarchyBuild = std::async(std::launch::async, [snapshot, structureVersion, closureVersion, cachePath]() {
+            std::unique_ptr<ContractionHierarchy> hierarchy(new ContractionHierarchy());
+            hierarchy->build(snapshot, structureVersion, closureVersion);
+            if (!cachePath.isEmpty()) hierarchy->save(cachePath);
+            return hierarchy;
+        });
+    }
+    return false;
+}
+
+bool GraphController::prepareHubLabels() {
+    if (m_hubLabels.isCurrent(*m_graph)) return true;
+    
+    if (m_hubLabelsBuild.valid() &&
+        m_hubLabelsBuild.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        try {
+            std::unique_ptr<HubLabels> built = m_hubLabelsBuild.get();
+            m_hubLabels = std::move(*built);
+            emit hubLabelsBuilt(m_hubLabels.nodeCount(), m_hubLabels.averageLabelSize(), m_hubLabels.memoryUsage());
+        } catch (...) {
+            emit errorOccurred("Error al construir las etiquetas de hubs");
         }
-        cost = dist[originIdx][destIdx];
+        if (m_hubLabels.isCurrent(*m_graph)) return true;
+    }
+    
+    if (!m_hubLabelsBuild.valid()) {
+        GraphSnapshot snapshot = m_graph->getSnapshot();
+        quint64 structureVersion = m_graph->getStructureVersion();
+        quint64 closureVersion = m_graph->getClosureVersion();
+        m_hubLabelsBuild = std::async(std::launch::async, [snapshot, structureVersion, closureVersion]() {
+            std::unique_ptr<HubLabels> labels(new HubLabels());
+            labels->build(snapshot, structureVersion, closureVersion);
+            return labels;
+        });
+    }
+    return false;
+}
+
+QVector<int> GraphController::floydWarshallSearch(int origin, int destination, double& cost) {
+    QVector<int> path;
+    cost = 0.0;
+    
+    if (!m_graph->hasStation(origin) || !m_graph->hasStation(destination)) {
+        return path;
+    }
+    
+    // The all-pairs result is reused until the graph changes; sparse networks
+    // get it from per-source Dijkstra, which yields the same table
+    if (!m_allPairs.isCurrent(*m_graph)) {
+        m_allPairs.compute(*m_graph);
+    }
+    
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    int originIdx = snapshot.indexOf(origin);
+    int destIdx = snapshot.indexOf(destination);
+    
+    for (int index : m_allPairs.path(originIdx, destIdx)) {
+        path.append(snapshot.stationIdAt(index));
+    }
+    if (!path.isEmpty()) {
+        cost = m_allPairs.distance(originIdx, destIdx);
     }
     
     return path;
@@ -423,16 +1238,29 @@ QVector<QPair<int,int>> GraphController::kruskalMST(double& totalCost) {
     QVector<QPair<int,int>> mstEdges;
     totalCost = 0.0;
     
-    QVector<Edge> allEdges = m_graph->getAllEdges();
-    QVector<Station> stations = m_graph->getAllStations();
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    int n = snapshot.nodeCount();
     
-    std::sort(allEdges.begin(), allEdges.end(), [](const Edge& a, const Edge& b) {
-        return a.getWeight() < b.getWeight();
+    QVector<int> sources(snapshot.edgeCount());
+    QVector<int> order(snapshot.edgeCount());
+    for (int from = 0; from < n; ++from) {
+        for (int e = offsets[from]; e < offsets[from + 1]; ++e) {
+            sources[e] = from;
+            order[e] = e;
+        }
+    }
+    
+    std::sort(order.begin(), order.end(), [&weights](int a, int b) {
+        return weights[a] < weights[b];
     });
     
-    QMap<int, int> parent;
-    for (const Station& station : stations) {
-        parent[station.getId()] = station.getId();
+    QVector<int> parent(n);
+    for (int i = 0; i < n; ++i) {
+        parent[i] = i;
     }
     
     auto find = [&parent](int x) {
@@ -453,10 +1281,10 @@ QVector<QPair<int,int>> GraphController::kruskalMST(double& totalCost) {
         return false;
     };
     
-    for (const Edge& edge : allEdges) {
-        if (!edge.isClosed() && unite(edge.getFrom(), edge.getTo())) {
-            mstEdges.append(qMakePair(edge.getFrom(), edge.getTo()));
-            totalCost += edge.getWeight();
+    for (int e : order) {
+        if (!closed[e] && unite(sources[e], targets[e])) {
+            mstEdges.append(qMakePair(snapshot.stationIdAt(sources[e]), snapshot.stationIdAt(targets[e])));
+            totalCost += weights[e];
         }
     }
     
@@ -467,45 +1295,36 @@ QVector<QPair<int,int>> GraphController::primMST(double& totalCost) {
     QVector<QPair<int,int>> mstEdges;
     totalCost = 0.0;
     
-    QVector<Station> stations = m_graph->getAllStations();
-    if (stations.isEmpty()) return mstEdges;
-    
-    QSet<int> inMST;
-    QMap<int, double> minWeight;
-    QMap<int, int> parent;
-    
-    int start = stations.first().getId();
-    for (const Station& station : stations) {
-        minWeight[station.getId()] = std::numeric_limits<double>::infinity();
-        parent[station.getId()] = -1;
-    }
-    minWeight[start] = 0.0;
-    
-    while (inMST.size() < stations.size()) {
-        int u = -1;
-        double minW = std::numeric_limits<double>::infinity();
-        for (const Station& station : stations) {
-            int id = station.getId();
-            if (!inMST.contains(id) && minWeight[id] < minW) {
-                minW = minWeight[id];
-                u = id;
-            }
-        }
-        
-        if (u == -1) break;
+    const GraphSnapshot& snapshot = m_graph->getSnapshot();
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    int n = snapshot.nodeCount();
+    if (n == 0) return mstEdges;
+    
+    // Labels hold the cheapest known connecting edge; visited means in the tree
+    SearchWorkspace& search = workspace();
+    IndexedMinHeap& heap = search.heap();
+    search.prepare(n);
+    
+    search.setLabel(0, 0.0, -1);
+    heap.push(0, 0.0);
+    
+    while (!heap.isEmpty()) {
+        int u = heap.popMin();
         
-        inMST.insert(u);
-        if (parent[u] != -1) {
-            mstEdges.append(qMakePair(parent[u], u));
-            totalCost += minWeight[u];
+        search.markVisited(u);
+        if (search.parent(u) != -1) {
+            mstEdges.append(qMakePair(snapshot.stationIdAt(search.parent(u)), snapshot.stationIdAt(u)));
+            totalCost += search.distance(u);
         }
         
-        QVector<Edge> edges = m_graph->getEdgesFrom(u);
-        for (const Edge& edge : edges) {
-            int v = edge.getTo();
-            if (!edge.isClosed() && !inMST.contains(v) && edge.getWeight() < minWeight[v]) {
-                minWeight[v] = edge.getWeight();
-                parent[v] = u;
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e) {
+            int v = targets[e];
+            if (!closed[e] && !search.isVisited(v) && weights[e] < search.distance(v)) {
+                search.setLabel(v, weights[e], u);
+                heap.pushOrDecrease(v, weights[e]);
             }
         }
     }
@@ -8,6 +8,19 @@
 #include "Station.h"
 #include "Edge.h"
 #include "ReportManager.h"
+#include "AllPairsShortestPaths.h"
+#include "ContractionHierarchy.h"
+#include "LandmarkIndex.h"
+#include "HubLabels.h"
+#include "DynamicShortestPaths.h"
+#include "SearchWorkspace.h"
+#include "DirectionOptimizingBfs.h"
+#include "DeltaStepping.h"
+#include "KShortestPaths.h"
+#include <future>
+#include <memory>
+
+class MutationJournal;
 
 class GraphController : public QObject {
     Q_OBJECT
@@ -18,16 +31,37 @@ public:
     
     Graph* getGraph();
     ReportManager* getReportManager();
+    void setJournal(MutationJournal* journal);
+    void setCachePath(const QString& path);
+    
+    QVector<double> hubLabelDistances(const QVector<QPair<int,int>>& queries);
+    QVector<double> distanceMatrix(const QVector<int>& sources, const QVector<int>& targets);
+    // Hops over open edges from origin, indexed like getAllStations(); -1 if unreachable
+    QVector<int> hopDistances(int origin);
+    // Full tree from origin by delta-stepping, same layout; parents are station IDs
+    bool shortestPathTree(int origin, QVector<double>& distances, QVector<int>& parents);
+    // Delta-stepping bucket width in km; zero or less picks one automatically
+    void setBucketWidth(double width);
     
 public slots:
     void addEdge(int from, int to, double weight);
     void removeEdge(int from, int to);
     void markEdgeClosed(int from, int to);
+    void reopenEdge(int from, int to);
+    void registerHub(int stationId);
+    void unregisterHub(int stationId);
     void loadMap();
     
     void runBFS(int origin, int destination);
     void runDFS(int origin, int destination);
     void runDijkstra(int origin, int destination);
+    void runIntegerDijkstra(int origin, int destination);
+    void runKShortest(int origin, int destination, int k);
+    void runAStar(int origin, int destination);
+    void runBidirectionalDijkstra(int origin, int destination);
+    void runContractionHierarchy(int origin, int destination);
+    void runLandmarkAStar(int origin, int destination);
+    void runHubLabels(int origin, int destination);
     void runFloydWarshall(int origin, int destination);
     void runKruskal();
     void runPrim();
@@ -38,8 +72,11 @@ signals:
     void connectionAdded(int from, int to, double weight, bool success);
     void connectionRemoved(int from, int to, bool success);
     void closureMarked(int from, int to, bool closed);
+    void hubRegistered(int stationId, bool success);
     void pathFound(const QString& algorithm, const QVector<int>& path, double cost);
     void pathNotFound(const QString& algorithm);
+    void kPathsFound(const QVector<QVector<int>>& paths, const QVector<double>& costs);
+    void hubLabelsBuilt(int stations, double averageLabelSize, qint64 memoryBytes);
     void mstFound(const QString& algorithm, const QVector<QPair<int,int>>& edges, double totalCost);
     void mapLoaded(const QVector<Station>& stations, const QVector<Edge>& edges);
     void reportGenerated(bool success);
@@ -48,15 +85,53 @@ signals:
 private:
     Graph* m_graph;
     ReportManager* m_reportManager;
+    MutationJournal* m_journal;
+    AllPairsShortestPaths m_allPairs;
+    ContractionHierarchy m_hierarchy;
+    // Contraction runs on a worker thread; queries never wait for it
+    std::future<std::unique_ptr<ContractionHierarchy>> m_hierarchyBuild;
+    QString m_cachePath;
+    LandmarkIndex m_landmarks;
+    HubLabels m_hubLabels;
+    std::future<std::unique_ptr<HubLabels>> m_hubLabelsBuild;
+    DynamicShortestPaths m_dynamicPaths;
+    // One per ParallelFor worker; serial searches use the first
+    QVector<SearchWorkspace> m_workspaces;
+    // Labels of the backward half of bidirectional Dijkstra
+    SearchWorkspace m_backwardWorkspace;
+    DirectionOptimizingBfs m_hopSearch;
+    DeltaStepping m_deltaStepping;
+    KShortestPaths m_kShortest;
+    
+    // A* heuristic inputs per snapshot index, rebuilt when the structure changes
+    QVector<double> m_stationX;
+    QVector<double> m_stationY;
+    double m_heuristicScale;
+    quint64 m_heuristicVersion;
+    bool m_heuristicValid;
     
     void addReportEntry(const QString& algorithm, int origin, int destination, 
-                        const QVector<int>& path, double cost);
+                        const QVector<int>& path, double cost,
+                        const QVector<QVector<int>>& alternatives = QVector<QVector<int>>(),
+                        const QVector<double>& alternativeCosts = QVector<double>());
     
     double calculatePathCost(const QVector<int>& path);
+    SearchWorkspace& workspace(int worker = 0);
     
     QVector<int> bfsSearch(int origin, int destination);
     QVector<int> dfsSearch(int origin, int destination);
     QVector<int> dijkstraSearch(int origin, int destination, double& cost);
+    QVector<int> integerDijkstraSearch(int origin, int destination, double& cost);
+    void kShortestSearch(int origin, int destination, int k, QVector<QVector<int>>& paths, QVector<double>& costs);
+    QVector<int> aStarSearch(int origin, int destination, double& cost);
+    QVector<int> bidirectionalDijkstraSearch(int origin, int destination, double& cost);
+    QVector<int> contractionHierarchySearch(int origin, int destination, double& cost, QString& algorithm);
+    QVector<int> landmarkSearch(int origin, int destination, double& cost);
+    QVector<int> hubLabelSearch(int origin, int destination, double& cost, QString& algorithm);
+    bool prepareHierarchy();
+    bool prepareHubLabels();
+    void dijkstraDistances(const QVector<QPair<int,int>>& queries, double* distances);
+    void prepareHeuristic();
     QVector<int> floydWarshallSearch(int origin, int destination, double& cost);
     QVector<QPair<int,int>> kruskalMST(double& totalCost);
     QVector<QPair<int,int>> primMST(double& totalCost);
@@ -0,0 +1,146 @@
+#include "GraphSnapshot.h"
+#include <limits>
+
+GraphSnapshot::GraphSnapshot() {}
+
+void GraphSnapshot::build(const QMap<int, Station>& stations, const QMap<int, QVector<Edge>>& adjacencyList) {
+    clear();
+    
+    int n = stations.size();
+    m_stationIds.reserve(n);
+    m_indexByStation.reserve(n);
+    for (auto it = stations.begin(); it != stations.end(); ++it) {
+        m_indexByStation.insert(it.key(), m_stationIds.size());
+        m_stationIds.append(it.key());
+    }
+    
+    m_offsets.reserve(n + 1);
+    m_offsets.append(0);
+    for (int i = 0; i < n; ++i) {
+        auto adjacency = adjacencyList.constFind(m_stationIds[i]);
+        if (adjacency != adjacencyList.constEnd()) {
+            for (const Edge& edge : adjacency.value()) {
+                auto target = m_indexByStation.constFind(edge.getTo());
+                if (target == m_indexByStation.constEnd()) continue;
+                m_targets.append(target.value());
+                m_weights.append(edge.getWeight());
+                m_metres.append(toMetres(edge.getWeight()));
+                m_closed.append(edge.isClosed() ? 1 : 0);
+            }
+        }
+        m_offsets.append(m_targets.size());
+    }
+    
+    buildReverse();
+}
+
+void GraphSnapshot::assign(const QVector<int>& stationIds, const QVector<int>& offsets, const QVector<int>& targets,
+                           const QVector<double>& weights, const QVector<char>& closed) {
+    m_stationIds = stationIds;
+    m_offsets = offsets;
+    m_targets = targets;
+    m_weights = weights;
+    m_closed = closed;
+    m_metres.resize(m_weights.size());
+    for (int e = 0; e < m_weights.size(); ++e) {
+        m_metres[e] = toMetres(m_weights[e]);
+    }
+    
+    m_indexByStation.clear();
+    m_indexByStation.reserve(m_stationIds.size());
+    for (int i = 0; i < m_stationIds.size(); ++i) {
+        m_indexByStation.insert(m_stationIds[i], i);
+    }
+    
+    buildReverse();
+}
+
+void GraphSnapshot::clear() {
+    m_offsets.clear();
+    m_targets.clear();
+    m_weights.clear();
+    m_metres.clear();
+    m_closed.clear();
+    m_stationIds.clear();
+    m_reverseOffsets.clear();
+    m_reverseSources.clear();
+    m_reverseEdges.clear();
+    m_indexByStation.clear();
+}
+
+void GraphSnapshot::buildReverse() {
+    int n = m_stationIds.size();
+    int m = m_targets.size();
+    
+    // Counting sort by target; scanning sources in order keeps each
+    // incoming list sorted by source index
+    m_reverseOffsets.fill(0, n + 1);
+    for (int e = 0; e < m; ++e) {
+        ++m_reverseOffsets[m_targets[e] + 1];
+    }
+    for (int i = 0; i < n; ++i) {
+        m_reverseOffsets[i + 1] += m_reverseOffsets[i];
+    }
+    
+    m_reverseSources.resize(m);
+    m_reverseEdges.resize(m);
+    QVector<int> cursor = m_reverseOffsets;
+    for (int i = 0; i < n; ++i) {
+        for (int e = m_offsets[i]; e < m_offsets[i + 1]; ++e) {
+            int slot = cursor[m_targets[e]]++;
+            m_reverseSources[slot] = i;
+            m_reverseEdges[slot] = e;
+        }
+    }
+}
+
+int GraphSnapshot::nodeCount() const { return m_stationIds.size(); }
+
+int GraphSnapshot::edgeCount() const { return m_targets.size(); }
+
+int GraphSnapshot::indexOf(int stationId) const {
+    return m_indexByStation.value(stationId, -1);
+}
+
+int GraphSnapshot::stationIdAt(int index) const { return m_stationIds[index]; }
+
+int GraphSnapshot::findEdge(int fromIndex, int toIndex) const {
+    for (int e = m_offsets[fromIndex]; e < m_offsets[fromIndex + 1]; ++e) {
+        if (m_targets[e] == toIndex) return e;
+    }
+    return -1;
+}
+
+int GraphSnapshot::edgeAt(int fromIndex, int slot, int toIndex) const {
+    // The CSR keeps adjacency order, so slot maps straight to an edge unless
+    // an edge to an unregistered station was skipped before it
+    int edge = m_offsets[fromIndex] + slot;
+    if (edge < m_offsets[fromIndex + 1] && m_targets[edge] == toIndex) return edge;
+    return findEdge(fromIndex, toIndex);
+}
+
+void GraphSnapshot::setClosed(int edge, bool closed) {
+    m_closed[edge] = closed ? 1 : 0;
+}
+
+void GraphSnapshot::setWeight(int edge, double weight) {
+    m_weights[edge] = weight;
+    m_metres[edge] = toMetres(weight);
+}
+
+const QVector<int>& GraphSnapshot::offsets() const { return m_offsets; }
+const QVector<int>& GraphSnapshot::targets() const { return m_targets; }
+const QVector<double>& GraphSnapshot::weights() const { return m_weights; }
+const QVector<quint32>& GraphSnapshot::metres() const { return m_metres; }
+const QVector<char>& GraphSnapshot::closed() const { return m_closed; }
+const QVector<int>& GraphSnapshot::stationIds() const { return m_stationIds; }
+const QVector<int>& GraphSnapshot::reverseOffsets() const { return m_reverseOffsets; }
+const QVector<int>& GraphSnapshot::reverseSources() const { return m_reverseSources; }
+const QVector<int>& GraphSnapshot::reverseEdges() const { return m_reverseEdges; }
+
+quint32 GraphSnapshot::toMetres(double kilometres) {
+    double metres = kilometres * 1000.0;
+    if (!(metres > 0.0)) return 0;
+    if (metres >= std::numeric_limits<quint32>::max()) return std::numeric_limits<quint32>::max();
+    return quint32(qRound64(metres));
+}
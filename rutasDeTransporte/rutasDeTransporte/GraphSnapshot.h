@@ -0,0 +1,71 @@
+#ifndef GRAPHSNAPSHOT_H
+#define GRAPHSNAPSHOT_H
+
+#include "Edge.h"
+#include "Station.h"
+#include <QVector>
+#include <QMap>
+#include <QHash>
+
+/**
+ * @brief Read-only compressed sparse row (CSR) view of the transport graph
+ *
+ * Stations are mapped to dense indices in ascending ID order. The outgoing
+ * edges of index i are stored in [offsets[i], offsets[i + 1]) of the target,
+ * weight and closed arrays, in the same order as the adjacency list they
+ * were built from. Edges pointing to unregistered stations are skipped.
+ *
+ * A reverse CSR lists the incoming edges of index i in
+ * [reverseOffsets[i], reverseOffsets[i + 1]) as source indices plus the
+ * forward edge they refer to, so weight and closure patches apply to both
+ * directions without touching the reverse arrays.
+ *
+ * Every weight is also kept in whole metres, rounded to the nearest one, for
+ * searches that need exact integer costs and monotone integer queues.
+ */
+class GraphSnapshot {
+public:
+    GraphSnapshot();
+    
+    void build(const QMap<int, Station>& stations, const QMap<int, QVector<Edge>>& adjacencyList);
+    void assign(const QVector<int>& stationIds, const QVector<int>& offsets, const QVector<int>& targets,
+                const QVector<double>& weights, const QVector<char>& closed);
+    void clear();
+    
+    int nodeCount() const;
+    int edgeCount() const;
+    
+    int indexOf(int stationId) const;
+    int stationIdAt(int index) const;
+    int findEdge(int fromIndex, int toIndex) const;
+    int edgeAt(int fromIndex, int slot, int toIndex) const;
+    void setClosed(int edge, bool closed);
+    void setWeight(int edge, double weight);
+    
+    const QVector<int>& offsets() const;
+    const QVector<int>& targets() const;
+    const QVector<double>& weights() const;
+    const QVector<quint32>& metres() const;
+    const QVector<char>& closed() const;
+    const QVector<int>& stationIds() const;
+    const QVector<int>& reverseOffsets() const;
+    const QVector<int>& reverseSources() const;
+    const QVector<int>& reverseEdges() const;
+    
+private:
+    QVector<int> m_offsets;
+    QVector<int> m_targets;
+    QVector<double> m_weights;
+    QVector<quint32> m_metres;
+    QVector<char> m_closed;
+    QVector<int> m_stationIds;
+    QVector<int> m_reverseOffsets;
+    QVector<int> m_reverseSources;
+    QVector<int> m_reverseEdges;
+    QHash<int, int> m_indexByStation;
+    
+    void buildReverse();
+    static quint32 toMetres(double kilometres);
+};
+
+#endif // GRAPHSNAPSHOT_H
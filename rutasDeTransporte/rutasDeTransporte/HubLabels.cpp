@@ -0,0 +1,256 @@
+#include "HubLabels.h"
+#include "Graph.h"
+#include "GraphSnapshot.h"
+#include "IndexedMinHeap.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// Shortest-path trees sampled to rank stations before labeling
+const int OrderSamples = 64;
+
+struct Label {
+    QVector<int> hubs;
+    QVector<double> distances;
+};
+
+void flatten(const QVector<Label>& labels, QVector<int>& offsets, QVector<int>& hubs, QVector<double>& distances) {
+    offsets.resize(labels.size() + 1);
+    offsets[0] = 0;
+    for (int i = 0; i < labels.size(); ++i) {
+        offsets[i + 1] = offsets[i] + labels[i].hubs.size();
+    }
+    hubs.resize(offsets.last());
+    distances.resize(offsets.last());
+    for (int i = 0; i < labels.size(); ++i) {
+        std::copy(labels[i].hubs.begin(), labels[i].hubs.end(), hubs.begin() + offsets[i]);
+        std::copy(labels[i].distances.begin(), labels[i].distances.end(), distances.begin() + offsets[i]);
+    }
+}
+
+}
+
+HubLabels::HubLabels()
+    : m_nodeCount(0), m_valid(false), m_structureVersion(0), m_closureVersion(0) {}
+
+bool HubLabels::isCurrent(const Graph& graph) const {
+    return m_valid && m_structureVersion == graph.getStructureVersion() &&
+           m_closureVersion == graph.getClosureVersion();
+}
+
+void HubLabels::build(const Graph& graph) {
+    build(graph.getSnapshot(), graph.getStructureVersion(), graph.getClosureVersion());
+}
+
+void HubLabels::build(const GraphSnapshot& snapshot, quint64 structureVersion, quint64 closureVersion) {
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    const QVector<int>& reverseOffsets = snapshot.reverseOffsets();
+    const QVector<int>& reverseSources = snapshot.reverseSources();
+    const QVector<int>& reverseEdges = snapshot.reverseEdges();
+    const double infinity = std::numeric_limits<double>::infinity();
+    int n = snapshot.nodeCount();
+    
+    // Stations that many shortest paths run through go first, so they end
+    // up as hubs and prune every later search early. Coverage is estimated
+    // as the summed subtree sizes over a few shortest-path trees
+    QVector<QVector<qint64>> workerCoverage(ParallelFor::workerCount(), QVector<qint64>(n, 0));
+    int samples = qMin(n, OrderSamples);
+    ParallelFor::run(samples, [&](int sample, int worker) {
+        int root = static_cast<int>(qint64(sample) * n / samples);
+        QVector<double> treeDistance(n, infinity);
+        QVector<int> treeParent(n, -1);
+        QVector<int> settled;
+        settled.reserve(n);
+        IndexedMinHeap treeHeap(n);
+        treeDistance[root] = 0.0;
+        treeHeap.push(root, 0.0);
+        while (!treeHeap.isEmpty()) {
+            int current = treeHeap.popMin();
+            settled.append(current);
+            for (int e = offsets[current]; e < offsets[current + 1]; ++e) {
+                if (closed[e]) continue;
+                int next = targets[e];
+                double newDistance = treeDistance[current] + weights[e];
+                if (newDistance < treeDistance[next]) {
+                    treeDistance[next] = newDistance;
+                    treeParent[next] = current;
+                    treeHeap.pushOrDecrease(next, newDistance);
+                }
+            }
+        }
+        
+        QVector<qint64> subtree(n, 1);
+        QVector<qint64>& coverage = workerCoverage[worker];
+        for (int i = settled.size() - 1; i >= 0; --i) {
+            int node = settled[i];
+            coverage[node] += subtree[node];
+            if (treeParent[node] != -1) subtree[treeParent[node]] += subtree[node];
+        }
+    });
+    
+    QVector<qint64> coverage(n, 0);
+    for (const QVector<qint64>& partial : workerCoverage) {
+        for (int v = 0; v < n; ++v) {
+            coverage[v] += partial[v];
+        }
+    }
+    QVector<int> order(n);
+    for (int v = 0; v < n; ++v) {
+        order[v] = v;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return coverage[a] > coverage[b]; });
+    
+    QVector<Label> outLabels(n);
+    QVector<Label> inLabels(n);
+    QVector<double> distance(n, infinity);
+    QVector<double> rootDistance(n, infinity);
+    QVector<int> touched;
+    IndexedMinHeap heap(n);
+    
+    for (int rank = 0; rank < n; ++rank) {
+        int root = order[rank];
+        
+        for (int direction = 0; direction < 2; ++direction) {
+            bool forward = direction == 0;
+            // The root's own label, spread into an array indexed by hub, turns
+            // each pruning test into one scan of the other station's label
+            const Label& rootLabel = forward ? outLabels[root] : inLabels[root];
+            for (int i = 0; i < rootLabel.hubs.size(); ++i) {
+                rootDistance[rootLabel.hubs[i]] = rootLabel.distances[i];
+            }
+            
+            distance[root] = 0.0;
+            touched.append(root);
+            heap.push(root, 0.0);
+            while (!heap.isEmpty()) {
+                int current = heap.popMin();
+                double currentDistance = distance[current];
+                
+                Label& label = forward ? inLabels[current] : outLabels[current];
+                bool covered = false;
+                for (int i = 0; i < label.hubs.size() && !covered; ++i) {
+                    covered = rootDistance[label.hubs[i]] + label.distances[i] <= currentDistance;
+                }
+                if (covered) continue;
+                label.hubs.append(rank);
+                label.distances.append(currentDistance);
+                
+                int begin = forward ? offsets[current] : reverseOffsets[current];
+                int end = forward ? offsets[current + 1] : reverseOffsets[current + 1];
+                for (int i = begin; i < end; ++i) {
+                    int edge = forward ? i : reverseEdges[i];
+                    if (closed[edge]) continue;
+                    int next = forward ? targets[i] : reverseSources[i];
+                    double newDistance = currentDistance + weights[edge];
+                    if (newDistance < distance[next]) {
+                        if (distance[next] == infinity) touched.append(next);
+                        distance[next] = newDistance;
+                        heap.pushOrDecrease(next, newDistance);
+                    }
+                }
+            }
+            
+            for (int v : touched) {
+                distance[v] = infinity;
+            }
+            touched.clear();
+            for (int hub : rootLabel.hubs) {
+                rootDistance[hub] = infinity;
+            }
+        }
+    }
+    
+    flatten(outLabels, m_outOffsets, m_outHubs, m_outDistances);
+    flatten(inLabels, m_inOffsets, m_inHubs, m_inDistances);
+    m_nodeCount = n;
+    m_valid = true;
+    m_structureVersion = structureVersion;
+    m_closureVersion = closureVersion;
+}
+
+void HubLabels::clear() {
+    m_nodeCount = 0;
+    m_outOffsets.clear();
+    m_outHubs.clear();
+    m_outDistances.clear();
+    m_inOffsets.clear();
+    m_inHubs.clear();
+    m_inDistances.clear();
+    m_valid = false;
+}
+
+int HubLabels::nodeCount() const { return m_nodeCount; }
+
+double HubLabels::distance(int fromIndex, int toIndex) const {
+    double best = std::numeric_limits<double>::infinity();
+    int i = m_outOffsets[fromIndex];
+    int iEnd = m_outOffsets[fromIndex + 1];
+    int j = m_inOffsets[toIndex];
+    int jEnd = m_inOffsets[toIndex + 1];
+    while (i < iEnd && j < jEnd) {
+        int outHub = m_outHubs[i];
+        int inHub = m_inHubs[j];
+        if (outHub == inHub) {
+            best = qMin(best, m_outDistances[i] + m_inDistances[j]);
+            ++i;
+            ++j;
+        } else if (outHub < inHub) {
+            ++i;
+        } else {
+            ++j;
+        }
+    }
+    return best;
+}
+
+QVector<int> HubLabels::path(const GraphSnapshot& snapshot, int fromIndex, int toIndex) const {
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    QVector<int> result;
+    
+    if (distance(fromIndex, toIndex) == std::numeric_limits<double>::infinity()) return result;
+    
+    // Walk forward, always taking the edge that keeps the remaining distance
+    // smallest; the step limit guards against zero-weight cycles
+    result.append(fromIndex);
+    int current = fromIndex;
+    while (current != toIndex) {
+        if (result.size() > m_nodeCount) return QVector<int>();
+        
+        int bestNext = -1;
+        double bestDistance = std::numeric_limits<double>::infinity();
+        for (int e = offsets[current]; e < offsets[current + 1]; ++e) {
+            if (closed[e]) continue;
+            double through = weights[e] + distance(targets[e], toIndex);
+            if (through < bestDistance) {
+                bestDistance = through;
+                bestNext = targets[e];
+            }
+        }
+        if (bestNext == -1) return QVector<int>();
+        result.append(bestNext);
+        current = bestNext;
+    }
+    return result;
+}
+
+qint64 HubLabels::entryCount() const {
+    return qint64(m_outHubs.size()) + m_inHubs.size();
+}
+
+double HubLabels::averageLabelSize() const {
+    if (m_nodeCount == 0) return 0.0;
+    return double(entryCount()) / (2.0 * m_nodeCount);
+}
+
+qint64 HubLabels::memoryUsage() const {
+    return qint64(m_outOffsets.size() + m_inOffsets.size()) * qint64(sizeof(int)) +
+           entryCount() * qint64(sizeof(int) + sizeof(double));
+}
@@ -0,0 +1,55 @@
+#ifndef HUBLABELS_H
+#define HUBLABELS_H
+
+#include <QVector>
+#include <QtGlobal>
+
+class Graph;
+class GraphSnapshot;
+
+/**
+ * @brief Hub labels for distance queries that never search the graph
+ *
+ * Built by pruned landmark labeling over the open edges: stations are
+ * processed by how many sampled shortest paths cross them, and each one runs a forward and a
+ * backward Dijkstra that stops at every station whose distance the labels
+ * built so far already answer. Every station ends up with an outgoing
+ * label (hubs it reaches) and an incoming label (hubs that reach it), both
+ * sorted by hub rank, so d(o, d) is a merge of two short arrays.
+ *
+ * Closed edges are not part of the labels; closures require a rebuild.
+ * The snapshot overload of build() only reads its arguments, so it can run
+ * on a copy of the snapshot in another thread.
+ */
+class HubLabels {
+public:
+    HubLabels();
+    
+    bool isCurrent(const Graph& graph) const;
+    void build(const Graph& graph);
+    void build(const GraphSnapshot& snapshot, quint64 structureVersion, quint64 closureVersion);
+    void clear();
+    
+    int nodeCount() const;
+    double distance(int fromIndex, int toIndex) const;
+    QVector<int> path(const GraphSnapshot& snapshot, int fromIndex, int toIndex) const;
+    
+    qint64 entryCount() const;
+    double averageLabelSize() const;
+    qint64 memoryUsage() const;
+    
+private:
+    int m_nodeCount;
+    // Labels in CSR form; hubs are ranks, in ascending order per station
+    QVector<int> m_outOffsets;
+    QVector<int> m_outHubs;
+    QVector<double> m_outDistances;
+    QVector<int> m_inOffsets;
+    QVector<int> m_inHubs;
+    QVector<double> m_inDistances;
+    bool m_valid;
+    quint64 m_structureVersion;
+    quint64 m_closureVersion;
+};
+
+#endif // HUBLABELS_H
@@ -0,0 +1,111 @@
+#include "IndexedMinHeap.h"
+
+IndexedMinHeap::IndexedMinHeap() {}
+
+IndexedMinHeap::IndexedMinHeap(int capacity) {
+    reset(capacity);
+}
+
+void IndexedMinHeap::reset(int capacity) {
+    m_heap.clear();
+    m_heap.reserve(capacity);
+    m_position.fill(-1, capacity);
+    m_keys.resize(capacity);
+}
+
+void IndexedMinHeap::clear() {
+    for (int index : m_heap) {
+        m_position[index] = -1;
+    }
+    m_heap.clear();
+}
+
+bool IndexedMinHeap::isEmpty() const { return m_heap.isEmpty(); }
+
+int IndexedMinHeap::size() const { return m_heap.size(); }
+
+bool IndexedMinHeap::contains(int index) const {
+    return m_position[index] != -1;
+}
+
+int IndexedMinHeap::top() const { return m_heap.first(); }
+
+double IndexedMinHeap::topKey() const { return m_keys[m_heap.first()]; }
+
+double IndexedMinHeap::keyOf(int index) const { return m_keys[index]; }
+
+void IndexedMinHeap::push(int index, double key) {
+    m_keys[index] = key;
+    m_position[index] = m_heap.size();
+    m_heap.append(index);
+    siftUp(m_heap.size() - 1);
+}
+
+void IndexedMinHeap::decreaseKey(int index, double key) {
+    m_keys[index] = key;
+    siftUp(m_position[index]);
+}
+
+void IndexedMinHeap::pushOrDecrease(int index, double key) {
+    if (contains(index)) {
+        decreaseKey(index, key);
+    } else {
+        push(index, key);
+    }
+}
+
+void IndexedMinHeap::changeKey(int index, double key) {
+    m_keys[index] = key;
+    siftUp(m_position[index]);
+    siftDown(m_position[index]);
+}
+
+int IndexedMinHeap::popMin() {
+    int result = m_heap.first();
+    int last = m_heap.last();
+    m_heap.removeLast();
+    m_position[result] = -1;
+    if (!m_heap.isEmpty()) {
+        m_heap[0] = last;
+        m_position[last] = 0;
+        siftDown(0);
+    }
+    return result;
+}
+
+bool IndexedMinHeap::lessThan(int a, int b) const {
+    if (m_keys[a] != m_keys[b]) return m_keys[a] < m_keys[b];
+    return a < b;
+}
+
+void IndexedMinHeap::siftUp(int slot) {
+    int index = m_heap[slot];
+    while (slot > 0) {
+        int parentSlot = (slot - 1) / 2;
+        int parentIndex = m_heap[parentSlot];
+        if (!lessThan(index, parentIndex)) break;
+        m_heap[slot] = parentIndex;
+        m_position[parentIndex] = slot;
+        slot = parentSlot;
+    }
+    m_heap[slot] = index;
+    m_position[index] = slot;
+}
+
+void IndexedMinHeap::siftDown(int slot) {
+    int index = m_heap[slot];
+    int count = m_heap.size();
+    while (true) {
+        int child = 2 * slot + 1;
+        if (child >= count) break;
+        if (child + 1 < count && lessThan(m_heap[child + 1], m_heap[child])) {
+            child++;
+        }
+        if (!lessThan(m_heap[child], index)) break;
+        m_heap[slot] = m_heap[child];
+        m_position[m_heap[slot]] = slot;
+        slot = child;
+    }
+    m_heap[slot] = index;
+    m_position[index] = slot;
+}
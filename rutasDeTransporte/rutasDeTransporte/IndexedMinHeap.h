@@ -0,0 +1,43 @@
+#ifndef INDEXEDMINHEAP_H
+#define INDEXEDMINHEAP_H
+
+#include <QVector>
+
+/**
+ * @brief Binary min-heap over dense indices [0, capacity) with decrease-key
+ *
+ * Ties on the key are broken by the smaller index, so the pop order is
+ * deterministic and matches a linear scan over stations sorted by ID.
+ */
+class IndexedMinHeap {
+public:
+    IndexedMinHeap();
+    explicit IndexedMinHeap(int capacity);
+    
+    void reset(int capacity);
+    void clear();
+    
+    bool isEmpty() const;
+    int size() const;
+    bool contains(int index) const;
+    int top() const;
+    double topKey() const;
+    double keyOf(int index) const;
+    
+    void push(int index, double key);
+    void decreaseKey(int index, double key);
+    void pushOrDecrease(int index, double key);
+    void changeKey(int index, double key);
+    int popMin();
+    
+private:
+    QVector<int> m_heap;
+    QVector<int> m_position;
+    QVector<double> m_keys;
+    
+    bool lessThan(int a, int b) const;
+    void siftUp(int slot);
+    void siftDown(int slot);
+};
+
+#endif // INDEXEDMINHEAP_H
@@ -0,0 +1,135 @@
+#include "KShortestPaths.h"
+#include "GraphSnapshot.h"
+#include "SearchWorkspace.h"
+#include <algorithm>
+
+KShortestPaths::KShortestPaths() {}
+
+void KShortestPaths::run(const GraphSnapshot& snapshot, SearchWorkspace& search, int originIdx, int destIdx, int k) {
+    m_routes.clear();
+    m_candidates.clear();
+    m_queue = decltype(m_queue)();
+    m_bannedTargets.clear();
+    if (k < 1) return;
+    
+    Route first;
+    first.deviation = 0;
+    if (originIdx == destIdx) {
+        first.nodes.append(originIdx);
+        first.distances.append(0.0);
+        m_routes.append(first);
+        return;
+    }
+    
+    search.prepare(snapshot.nodeCount());
+    if (!spurSearch(snapshot, search, originIdx, destIdx)) return;
+    for (int node = destIdx; node != -1; node = search.parent(node)) {
+        first.nodes.append(node);
+        first.distances.append(search.distance(node));
+    }
+    std::reverse(first.nodes.begin(), first.nodes.end());
+    std::reverse(first.distances.begin(), first.distances.end());
+    m_routes.append(first);
+    
+    while (m_routes.size() < k) {
+        addSpurs(snapshot, search, m_routes.last(), destIdx);
+        
+        // Different roots can spur into the same route; only its first copy counts
+        bool found = false;
+        while (!m_queue.empty() && !found) {
+            int index = m_queue.top().second;
+            m_queue.pop();
+            if (isAccepted(m_candidates[index])) continue;
+            m_routes.append(m_candidates[index]);
+            found = true;
+        }
+        if (!found) break;
+    }
+    
+    m_candidates.clear();
+    m_queue = decltype(m_queue)();
+}
+
+int KShortestPaths::pathCount() const { return m_routes.size(); }
+
+const QVector<int>& KShortestPaths::path(int i) const { return m_routes[i].nodes; }
+
+double KShortestPaths::cost(int i) const { return m_routes[i].distances.last(); }
+
+void KShortestPaths::addSpurs(const GraphSnapshot& snapshot, SearchWorkspace& search, const Route& route, int destIdx) {
+    for (int i = route.deviation; i + 1 < route.nodes.size(); ++i) {
+        int spurIdx = route.nodes[i];
+        
+        // Accepted routes with the same root must not be found again
+        m_bannedTargets.clear();
+        for (const Route& accepted : m_routes) {
+            if (accepted.nodes.size() > i + 1 &&
+                std::equal(route.nodes.begin(), route.nodes.begin() + i + 1, accepted.nodes.begin())) {
+                m_bannedTargets.append(accepted.nodes[i + 1]);
+            }
+        }
+        
+        // Root stations count as settled, which keeps the spur loopless
+        search.prepare(snapshot.nodeCount());
+        for (int j = 0; j < i; ++j) {
+            search.setLabel(route.nodes[j], 0.0, -1);
+            search.markVisited(route.nodes[j]);
+        }
+        if (!spurSearch(snapshot, search, spurIdx, destIdx)) continue;
+        
+        Route candidate;
+        candidate.nodes = route.nodes.mid(0, i);
+        candidate.distances = route.distances.mid(0, i);
+        candidate.deviation = i;
+        for (int node = destIdx; node != -1; node = search.parent(node)) {
+            candidate.nodes.append(node);
+            candidate.distances.append(route.distances[i] + search.distance(node));
+        }
+        std::reverse(candidate.nodes.begin() + i, candidate.nodes.end());
+        std::reverse(candidate.distances.begin() + i, candidate.distances.end());
+        
+        m_queue.push(qMakePair(candidate.distances.last(), static_cast<int>(m_candidates.size())));
+        m_candidates.append(candidate);
+    }
+}
+
+bool KShortestPaths::spurSearch(const GraphSnapshot& snapshot, SearchWorkspace& search, int spurIdx, int destIdx) {
+    const QVector<int>& offsets = snapshot.offsets();
+    const QVector<int>& targets = snapshot.targets();
+    const QVector<double>& weights = snapshot.weights();
+    const QVector<char>& closed = snapshot.closed();
+    IndexedMinHeap& heap = search.heap();
+    
+    search.setLabel(spurIdx, 0.0, -1);
+    heap.push(spurIdx, 0.0);
+    
+    while (!heap.isEmpty()) {
+        int current = heap.popMin();
+        search.markVisited(current);
+        
+        if (current == destIdx) {
+            break;
+        }
+        
+        for (int e = offsets[current]; e < offsets[current + 1]; ++e) {
+            int next = targets[e];
+            if (closed[e] || search.isVisited(next)) continue;
+            if (current == spurIdx && m_bannedTargets.contains(next)) continue;
+            
+            double newDistance = search.distance(current) + weights[e];
+            if (newDistance < search.distance(next)) {
+                search.setLabel(next, newDistance, current);
+                heap.pushOrDecrease(next, newDistance);
+            }
+        }
+    }
+    
+    return search.isVisited(destIdx);
+}
+
+bool KShortestPaths::isAccepted(const Route& route) const {
+    for (const Route& accepted : m_routes) {
+        if (accepted.nodes == route.nodes) return true;
+    }
+    return false;
+}
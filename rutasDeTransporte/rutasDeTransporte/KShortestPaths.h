@@ -0,0 +1,55 @@
+#ifndef KSHORTESTPATHS_H
+#define KSHORTESTPATHS_H
+
+#include <QVector>
+#include <QPair>
+#include <functional>
+#include <queue>
+#include <vector>
+
+class GraphSnapshot;
+class SearchWorkspace;
+
+/**
+ * @brief The k cheapest loopless routes between two stations (Yen's algorithm)
+ *
+ * Every accepted route is taken apart station by station: the part up to a
+ * station is kept as a root, and a Dijkstra search from that station finds
+ * the cheapest way on that avoids the root's stations and the next hop of
+ * every accepted route sharing the root. Those root + spur candidates wait
+ * in a min-heap and the cheapest one becomes the next route.
+ *
+ * Following Lawler, a route only spurs from the station where it left the
+ * route that produced it; the earlier roots were already searched from that
+ * route. Closed edges are ignored. Routes hold station indices.
+ */
+class KShortestPaths {
+public:
+    KShortestPaths();
+    
+    void run(const GraphSnapshot& snapshot, SearchWorkspace& search, int originIdx, int destIdx, int k);
+    int pathCount() const;
+    const QVector<int>& path(int i) const;
+    double cost(int i) const;
+    
+private:
+    struct Route {
+        QVector<int> nodes;
+        // Cost from the origin to each station of the route
+        QVector<double> distances;
+        // First station whose next hop differs from the parent route
+        int deviation;
+    };
+    
+    QVector<Route> m_routes;
+    QVector<Route> m_candidates;
+    std::priority_queue<QPair<double, int>, std::vector<QPair<double, int>>,
+                        std::greater<QPair<double, int>>> m_queue;
+    QVector<int> m_bannedTargets;
+    
+    void addSpurs(const GraphSnapshot& snapshot, SearchWorkspace& search, const Route& route, int destIdx);
+    bool spurSearch(const GraphSnapshot& snapshot, SearchWorkspace& search, int spurIdx, int destIdx);
+    bool isAccepted(const Route& route) const;
+};
+
+#endif // KSHORTESTPATHS_H
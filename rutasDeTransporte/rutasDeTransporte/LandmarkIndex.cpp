@@ -0,0 +1,133 @@
+#include "LandmarkIndex.h"
+#include "Graph.h"
+#include "GraphSnapshot.h"
+#include "IndexedMinHeap.h"
+#include "ParallelFor.h"
+#include <limits>
+
+LandmarkIndex::LandmarkIndex()
+    : m_nodeCount(0), m_valid(false), m_structureVersion(0) {}
+
+bool LandmarkIndex::isCurrent(const Graph& graph) const {
+    return m_valid && m_structureVersion == graph.getStructureVersion();
+}
+
+void LandmarkIndex::build(const Graph& graph, int landmarkCount) {
+    const GraphSnapshot& snapshot = graph.getSnapshot();
+    const double infinity = std::numeric_limits<double>::infinity();
+    int n = snapshot.nodeCount();
+    int k = qMin(landmarkCount, n);
+    
+    m_nodeCount = n;
+    m_landmarks.clear();
+    m_fromLandmark.fill(infinity, qint64(n) * k);
+    m_toLandmark.fill(infinity, qint64(n) * k);
+    
+    QVector<double> forward;
+    QVector<double> backward;
+    auto search = [&](int source) {
+        ParallelFor::run(2, [&](int task, int) {
+            if (task == 0) distances(snapshot, source, false, forward);
+            else distances(snapshot, source, true, backward);
+        });
+    };
+    
+    // Seeding with the round trip from the first station makes the first
+    // landmark the station farthest from it rather than the station itself
+    QVector<double> closest(n, infinity);
+    QVector<bool> isLandmark(n, false);
+    if (n > 0) {
+        search(0);
+        for (int v = 0; v < n; ++v) {
+            closest[v] = forward[v] + backward[v];
+        }
+    }
+    
+    for (int l = 0; l < k; ++l) {
+        int landmark = -1;
+        for (int v = 0; v < n; ++v) {
+            if (isLandmark[v]) continue;
+            if (landmark == -1 || closest[v] > closest[landmark]) landmark = v;
+        }
+        isLandmark[landmark] = true;
+        m_landmarks.append(landmark);
+        
+        search(landmark);
+        for (int v = 0; v < n; ++v) {
+            m_fromLandmark[qint64(v) * k + l] = forward[v];
+            m_toLandmark[qint64(v) * k + l] = backward[v];
+            closest[v] = qMin(closest[v], forward[v] + backward[v]);
+        }
+    }
+    
+    m_valid = true;
+    m_structureVersion = graph.getStructureVersion();
+}
+
+void LandmarkIndex::clear() {
+    m_nodeCount = 0;
+    m_landmarks.clear();
+    m_fromLandmark.clear();
+    m_toLandmark.clear();
+    m_valid = false;
+}
+
+int LandmarkIndex::landmarkCount() const { return m_landmarks.size(); }
+
+const QVector<int>& LandmarkIndex::landmarks() const { return m_landmarks; }
+
+double LandmarkIndex::lowerBound(int fromIndex, int toIndex) const {
+    const double infinity = std::numeric_limits<double>::infinity();
+    const int k = m_landmarks.size();
+    const double* fromLandmarkV = m_fromLandmark.constData() + qint64(fromIndex) * k;
+    const double* fromLandmarkT = m_fromLandmark.constData() + qint64(toIndex) * k;
+    const double* toLandmarkV = m_toLandmark.constData() + qint64(fromIndex) * k;
+    const double* toLandmarkT = m_toLandmark.constData() + qint64(toIndex) * k;
+    
+    // An infinite bound means the landmark proves t unreachable from v
+    double bound = 0.0;
+    for (int l = 0; l < k; ++l) {
+        // d(v, t) >= d(L, t) - d(L, v)
+        if (fromLandmarkV[l] != infinity) {
+            if (fromLandmarkT[l] == infinity) return infinity;
+            bound = qMax(bound, fromLandmarkT[l] - fromLandmarkV[l]);
+        }
+        // d(v, t) >= d(v, L) - d(t, L)
+        if (toLandmarkT[l] != infinity) {
+            if (toLandmarkV[l] == infinity) return infinity;
+            bound = qMax(bound, toLandmarkV[l] - toLandmarkT[l]);
+        }
+    }
+    return bound;
+}
+
+void LandmarkIndex::distances(const GraphSnapshot& snapshot, int source, bool reverse, QVector<double>& result) {
+    const QVector<int>& offsets = reverse ? snapshot.reverseOffsets() : snapshot.offsets();
+    const QVector<int>& neighbours = reverse ? snapshot.reverseSources() : snapshot.targets();
+    const QVector<int>& reverseEdges = snapshot.reverseEdges();
+    const QVector<double>& weights = snapshot.weights();
+    int n = snapshot.nodeCount();
+    
+    result.fill(std::numeric_limits<double>::infinity(), n);
+    QVector<bool> visited(n, false);
+    IndexedMinHeap heap(n);
+    result[source] = 0.0;
+    heap.push(source, 0.0);
+    
+    // Closed edges are deliberately relaxed too, see the class comment
+    while (!heap.isEmpty()) {
+        int current = heap.popMin();
+        visited[current] = true;
+        
+        for (int i = offsets[current]; i < offsets[current + 1]; ++i) {
+            int next = neighbours[i];
+            if (visited[next]) continue;
+            
+            double newDistance = result[current] + weights[reverse ? reverseEdges[i] : i];
+            if (newDistance < result[next]) {
+                result[next] = newDistance;
+                heap.pushOrDecrease(next, newDistance);
+            }
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef LANDMARKINDEX_H
+#define LANDMARKINDEX_H
+
+#include <QVector>
+#include <QtGlobal>
+
+class Graph;
+class GraphSnapshot;
+
+/**
+ * @brief Landmark distance tables for A* lower bounds (ALT)
+ *
+ * Landmarks are picked farthest-first: each new one is the station whose
+ * round trip to the closest landmark chosen so far is longest, so stations
+ * in unreached components are picked before anything else. For every
+ * landmark L the tables keep d(L, v) and d(v, L), and the triangle
+ * inequality turns them into lower bounds on d(v, t).
+ *
+ * The tables are computed with closed edges treated as open. Closing an
+ * edge can only make distances longer, so the bounds stay admissible and
+ * consistent across closures; only structural changes require a rebuild.
+ */
+class LandmarkIndex {
+public:
+    static const int DefaultLandmarkCount = 8;
+    
+    LandmarkIndex();
+    
+    bool isCurrent(const Graph& graph) const;
+    void build(const Graph& graph, int landmarkCount = DefaultLandmarkCount);
+    void clear();
+    
+    int landmarkCount() const;
+    const QVector<int>& landmarks() const;
+    double lowerBound(int fromIndex, int toIndex) const;
+    
+private:
+    int m_nodeCount;
+    QVector<int> m_landmarks;
+    // Station-major: entry v * landmarkCount + l belongs to landmark l
+    QVector<double> m_fromLandmark;
+    QVector<double> m_toLandmark;
+    bool m_valid;
+    quint64 m_structureVersion;
+    
+    static void distances(const GraphSnapshot& snapshot, int source, bool reverse, QVector<double>& result);
+};
+
+#endif // LANDMARKINDEX_H
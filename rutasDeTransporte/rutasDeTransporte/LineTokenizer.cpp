@@ -0,0 +1,114 @@
+#include "LineTokenizer.h"
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+inline void trim(const char*& begin, const char*& end) {
+    while (begin < end && isBlank(*begin)) ++begin;
+    while (end > begin && isBlank(*(end - 1))) --end;
+}
+
+inline bool contains(const char* begin, const char* end, char c) {
+    return std::memchr(begin, c, end - begin) != nullptr;
+}
+
+}
+
+LineTokenizer::LineTokenizer(const char* data, qint64 size) 
+    : m_cursor(data), m_end(data + size), m_separator(' ') {
+    if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+        m_cursor += 3;
+    }
+}
+
+bool LineTokenizer::nextRecord() {
+    while (m_cursor < m_end) {
+        const char* lineBegin = m_cursor;
+        const char* newline = static_cast<const char*>(std::memchr(m_cursor, '\n', m_end - m_cursor));
+        const char* lineEnd = newline ? newline : m_end;
+        m_cursor = newline ? newline + 1 : m_end;
+        
+        trim(lineBegin, lineEnd);
+        qint64 length = lineEnd - lineBegin;
+        if (length == 0 || lineBegin[0] == '#' || (length >= 2 && lineBegin[0] == '/' && lineBegin[1] == '/')) {
+            continue;
+        }
+        
+        if (contains(lineBegin, lineEnd, ';')) {
+            m_separator = ';';
+        } else if (contains(lineBegin, lineEnd, ',')) {
+            m_separator = ',';
+        } else if (contains(lineBegin, lineEnd, '\t')) {
+            m_separator = '\t';
+        } else {
+            m_separator = ' ';
+        }
+        
+        if (m_separator == ' ') {
+            splitOnWhitespace(lineBegin, lineEnd);
+        } else {
+            splitOn(lineBegin, lineEnd, m_separator);
+        }
+        return true;
+    }
+    return false;
+}
+
+int LineTokenizer::fieldCount() const { return m_fields.size(); }
+
+char LineTokenizer::separator() const { return m_separator; }
+
+bool LineTokenizer::toInt(int field, int& value) const {
+    const char* begin = m_fields[field].begin;
+    const char* end = m_fields[field].end;
+    if (begin < end && *begin == '+') ++begin;
+    if (begin == end) return false;
+    auto result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+bool LineTokenizer::toDouble(int field, double& value) const {
+    const char* begin = m_fields[field].begin;
+    const char* end = m_fields[field].end;
+    if (begin < end && *begin == '+') ++begin;
+    if (begin == end) return false;
+    auto result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+QString LineTokenizer::toString(int field) const {
+    const Span& span = m_fields[field];
+    return QString::fromUtf8(span.begin, span.end - span.begin);
+}
+
+void LineTokenizer::splitOn(const char* begin, const char* end, char separator) {
+    m_fields.clear();
+    const char* fieldBegin = begin;
+    for (const char* p = begin; ; ++p) {
+        if (p == end || *p == separator) {
+            const char* b = fieldBegin;
+            const char* e = p;
+            trim(b, e);
+            m_fields.append(Span{b, e});
+            if (p == end) break;
+            fieldBegin = p + 1;
+        }
+    }
+}
+
+void LineTokenizer::splitOnWhitespace(const char* begin, const char* end) {
+    m_fields.clear();
+    const char* p = begin;
+    while (p < end) {
+        while (p < end && isBlank(*p)) ++p;
+        if (p == end) break;
+        const char* fieldBegin = p;
+        while (p < end && !isBlank(*p)) ++p;
+        m_fields.append(Span{fieldBegin, p});
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef LINETOKENIZER_H
+#define LINETOKENIZER_H
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Zero-copy tokenizer for the delimited data files
+ *
+ * Walks a UTF-8 buffer line by line, skipping blank lines and lines that
+ * start with "#" or "//". Each record is split on the first separator found
+ * in the line, tried in the order ';', ',', tab and finally runs of
+ * whitespace (reported as ' '). Fields are trimmed views into the buffer; nothing is copied
+ * until a field is converted to a QString.
+ */
+class LineTokenizer {
+public:
+    LineTokenizer(const char* data, qint64 size);
+    
+    bool nextRecord();
+    int fieldCount() const;
+    char separator() const;
+    
+    bool toInt(int field, int& value) const;
+    bool toDouble(int field, double& value) const;
+    QString toString(int field) const;
+    
+private:
+    struct Span {
+        const char* begin;
+        const char* end;
+    };
+    
+    const char* m_cursor;
+    const char* m_end;
+    QVector<Span> m_fields;
+    char m_separator;
+    
+    void splitOn(const char* begin, const char* end, char separator);
+    void splitOnWhitespace(const char* begin, const char* end);
+};
+
+#endif // LINETOKENIZER_H
@@ -0,0 +1,40 @@
+#include "MappedFile.h"
+
+MappedFile::MappedFile(const QString& path) 
+    : m_file(path), m_map(nullptr), m_size(0) {}
+
+MappedFile::~MappedFile() { close(); }
+
+bool MappedFile::open() {
+    close();
+    if (!m_file.open(QIODevice::ReadOnly)) return false;
+    
+    m_size = m_file.size();
+    if (m_size > 0) {
+        m_map = m_file.map(0, m_size);
+        if (m_map == nullptr) {
+            m_buffer = m_file.readAll();
+            m_size = m_buffer.size();
+        }
+    }
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_map != nullptr) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    if (m_file.isOpen()) m_file.close();
+    m_buffer.clear();
+    m_size = 0;
+}
+
+const char* MappedFile::data() const {
+    if (m_map != nullptr) return reinterpret_cast<const char*>(m_map);
+    return m_buffer.constData();
+}
+
+qint64 MappedFile::size() const { return m_size; }
+
+bool MappedFile::isMapped() const { return m_map != nullptr; }
@@ -0,0 +1,36 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <QFile>
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief Read-only view of a whole file, memory-mapped when possible
+ *
+ * Falls back to reading the file into a buffer when the platform or the
+ * device (e.g. a Qt resource) cannot be mapped.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const QString& path);
+    ~MappedFile();
+    
+    bool open();
+    void close();
+    
+    const char* data() const;
+    qint64 size() const;
+    bool isMapped() const;
+    
+private:
+    QFile m_file;
+    uchar* m_map;
+    QByteArray m_buffer;
+    qint64 m_size;
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,126 @@
+#include "MinPlusKernel.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define MINPLUS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(MINPLUS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MINPLUS_AVX2 __attribute__((target("avx2")))
+#else
+#define MINPLUS_AVX2
+#endif
+
+namespace {
+
+template <typename T>
+void relaxScalar(T* row, int* nextRow, const T* pivotRow, T throughPivot, int firstHop, int begin, int count) {
+    for (int j = begin; j < count; ++j) {
+        T candidate = throughPivot + pivotRow[j];
+        if (candidate < row[j]) {
+            row[j] = candidate;
+            nextRow[j] = firstHop;
+        }
+    }
+}
+
+#ifdef MINPLUS_X86
+
+bool detectAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osSavesYmm || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+MINPLUS_AVX2 void relaxAvx2(double* row, int* nextRow, const double* pivotRow,
+                            double throughPivot, int firstHop, int count) {
+    const __m256d through = _mm256_set1_pd(throughPivot);
+    const __m128i hop = _mm_set1_epi32(firstHop);
+    int j = 0;
+    for (; j + 4 <= count; j += 4) {
+        __m256d current = _mm256_loadu_pd(row + j);
+        __m256d candidate = _mm256_add_pd(through, _mm256_loadu_pd(pivotRow + j));
+        __m256d better = _mm256_cmp_pd(candidate, current, _CMP_LT_OQ);
+        if (_mm256_movemask_pd(better) == 0) continue;
+        
+        _mm256_storeu_pd(row + j, _mm256_blendv_pd(current, candidate, better));
+        // Narrow the four 64-bit lane masks to 32-bit lanes for the hop blend
+        __m256 halves = _mm256_castpd_ps(better);
+        __m128 mask = _mm_shuffle_ps(_mm256_castps256_ps128(halves), _mm256_extractf128_ps(halves, 1),
+                                     _MM_SHUFFLE(2, 0, 2, 0));
+        __m128i hops = _mm_loadu_si128(reinterpret_cast<const __m128i*>(nextRow + j));
+        hops = _mm_blendv_epi8(hops, hop, _mm_castps_si128(mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(nextRow + j), hops);
+    }
+    relaxScalar(row, nextRow, pivotRow, throughPivot, firstHop, j, count);
+}
+
+MINPLUS_AVX2 void relaxAvx2(float* row, int* nextRow, const float* pivotRow,
+                            float throughPivot, int firstHop, int count) {
+    const __m256 through = _mm256_set1_ps(throughPivot);
+    const __m256i hop = _mm256_set1_epi32(firstHop);
+    int j = 0;
+    for (; j + 8 <= count; j += 8) {
+        __m256 current = _mm256_loadu_ps(row + j);
+        __m256 candidate = _mm256_add_ps(through, _mm256_loadu_ps(pivotRow + j));
+        __m256 better = _mm256_cmp_ps(candidate, current, _CMP_LT_OQ);
+        if (_mm256_movemask_ps(better) == 0) continue;
+        
+        _mm256_storeu_ps(row + j, _mm256_blendv_ps(current, candidate, better));
+        __m256i hops = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(nextRow + j));
+        hops = _mm256_blendv_epi8(hops, hop, _mm256_castps_si256(better));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(nextRow + j), hops);
+    }
+    relaxScalar(row, nextRow, pivotRow, throughPivot, firstHop, j, count);
+}
+
+#endif
+
+}
+
+bool MinPlusKernel::hasAvx2() {
+#ifdef MINPLUS_X86
+    static const bool supported = detectAvx2();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+void MinPlusKernel::relaxRow(double* row, int* nextRow, const double* pivotRow,
+                             double throughPivot, int firstHop, int count) {
+#ifdef MINPLUS_X86
+    if (hasAvx2()) {
+        relaxAvx2(row, nextRow, pivotRow, throughPivot, firstHop, count);
+        return;
+    }
+#endif
+    relaxScalar(row, nextRow, pivotRow, throughPivot, firstHop, 0, count);
+}
+
+void MinPlusKernel::relaxRow(float* row, int* nextRow, const float* pivotRow,
+                             float throughPivot, int firstHop, int count) {
+#ifdef MINPLUS_X86
+    if (hasAvx2()) {
+        relaxAvx2(row, nextRow, pivotRow, throughPivot, firstHop, count);
+        return;
+    }
+#endif
+    relaxScalar(row, nextRow, pivotRow, throughPivot, firstHop, 0, count);
+}
@@ -0,0 +1,21 @@
+#ifndef MINPLUSKERNEL_H
+#define MINPLUSKERNEL_H
+
+/**
+ * @brief Row relaxation step of Floyd-Warshall: for every j,
+ *        if (throughPivot + pivotRow[j] < row[j]) take it and set nextRow[j]
+ *
+ * Uses AVX2 when the CPU and OS support it, chosen once at run time, and a
+ * plain loop otherwise. Both paths give bit-identical results.
+ */
+class MinPlusKernel {
+public:
+    static bool hasAvx2();
+    
+    static void relaxRow(double* row, int* nextRow, const double* pivotRow,
+                         double throughPivot, int firstHop, int count);
+    static void relaxRow(float* row, int* nextRow, const float* pivotRow,
+                         float throughPivot, int firstHop, int count);
+};
+
+#endif // MINPLUSKERNEL_H
@@ -0,0 +1,343 @@
+#include "MutationJournal.h"
+#include "MappedFile.h"
+#include <QSaveFile>
+#include <QStringList>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const int DefaultCompactionThreshold = 1000;
+
+QString escapeField(const QString& field) {
+    QString result;
+    result.reserve(field.size());
+    for (QChar c : field) {
+        if (c == '\\') result += "\\\\";
+        else if (c == '\t') result += "\\t";
+        else if (c == '\n') result += "\\n";
+        else if (c == '\r') result += "\\r";
+        else result += c;
+    }
+    return result;
+}
+
+QString unescapeField(const QString& field) {
+    QString result;
+    result.reserve(field.size());
+    for (int i = 0; i < field.size(); ++i) {
+        if (field[i] == '\\' && i + 1 < field.size()) {
+            QChar next = field[++i];
+            if (next == 't') result += '\t';
+            else if (next == 'n') result += '\n';
+            else if (next == 'r') result += '\r';
+            else result += next;
+        } else {
+            result += field[i];
+        }
+    }
+    return result;
+}
+
+bool parseEntry(const QStringList& fields, MutationJournal::Entry& entry) {
+    if (fields.isEmpty() || fields[0].size() != 1) return false;
+    
+    bool ok1 = true, ok2 = true, ok3 = true;
+    entry.first = 0;
+    entry.second = 0;
+    entry.weight = 0.0;
+    
+    switch (fields[0].at(0).toLatin1()) {
+    case 'G':
+        if (fields.size() != 2) return false;
+        entry.operation = MutationJournal::Operation::Compaction;
+        entry.first = fields[1].toInt(&ok1);
+        return ok1;
+    case 'S':
+        if (fields.size() != 3) return false;
+        entry.operation = MutationJournal::Operation::InsertStation;
+        entry.first = fields[1].toInt(&ok1);
+        entry.name = unescapeField(fields[2]);
+        return ok1;
+    case 'D':
+        if (fields.size() != 2) return false;
+        entry.operation = MutationJournal::Operation::DeleteStation;
+        entry.first = fields[1].toInt(&ok1);
+        return ok1;
+    case 'A':
+        if (fields.size() != 4) return false;
+        entry.operation = MutationJournal::Operation::AddEdge;
+        entry.first = fields[1].toInt(&ok1);
+        entry.second = fields[2].toInt(&ok2);
+        entry.weight = fields[3].toDouble(&ok3);
+        return ok1 && ok2 && ok3;
+    case 'R':
+    case 'C':
+    case 'O':
+        if (fields.size() != 3) return false;
+        entry.operation = fields[0] == "R" ? MutationJournal::Operation::RemoveEdge
+                        : fields[0] == "C" ? MutationJournal::Operation::CloseEdge
+                                           : MutationJournal::Operation::ReopenEdge;
+        entry.first = fields[1].toInt(&ok1);
+        entry.second = fields[2].toInt(&ok2);
+        return ok1 && ok2;
+    case 'P': {
+        // P ts algorithm originId originName destinationId destinationName cost count (id name)*
+        //   [alternativeCount (cost count (id name)*)*]
+        if (fields.size() < 9) return false;
+        ReportManager::ReportEntry& report = entry.report;
+        entry.operation = MutationJournal::Operation::AppendReport;
+        report.timestamp = QDateTime::fromString(fields[1], Qt::ISODateWithMs);
+        report.algorithm = unescapeField(fields[2]);
+        report.originId = fields[3].toInt(&ok1);
+        report.originName = unescapeField(fields[4]);
+        report.destinationId = fields[5].toInt(&ok2);
+        report.destinationName = unescapeField(fields[6]);
+        report.totalCost = fields[7].toDouble(&ok3);
+        bool okCount = false;
+        int count = fields[8].toInt(&okCount);
+        if (!ok1 || !ok2 || !ok3 || !okCount || count < 0 || fields.size() < 9 + 2 * count) return false;
+        report.path.clear();
+        report.pathNames.clear();
+        for (int i = 0; i < count; ++i) {
+            bool ok = false;
+            report.path.append(fields[9 + 2 * i].toInt(&ok));
+            if (!ok) return false;
+            report.pathNames.append(unescapeField(fields[10 + 2 * i]));
+        }
+        
+        // Lines written before alternatives were journaled end here
+        report.alternatives.clear();
+        int next = 9 + 2 * count;
+        if (next == fields.size()) return true;
+        int alternativeCount = fields[next++].toInt(&okCount);
+        if (!okCount || alternativeCount < 0) return false;
+        for (int a = 0; a < alternativeCount; ++a) {
+            if (fields.size() < next + 2) return false;
+            ReportManager::Alternative alternative;
+            alternative.totalCost = fields[next].toDouble(&ok1);
+            count = fields[next + 1].toInt(&okCount);
+            next += 2;
+            if (!ok1 || !okCount || count < 0 || fields.size() < next + 2 * count) return false;
+            for (int i = 0; i < count; ++i) {
+                bool ok = false;
+                alternative.path.append(fields[next + 2 * i].toInt(&ok));
+                if (!ok) return false;
+                alternative.pathNames.append(unescapeField(fields[next + 2 * i + 1]));
+            }
+            next += 2 * count;
+            report.alternatives.append(alternative);
+        }
+        return next == fields.size();
+    }
+    default:
+        return false;
+    }
+}
+
+}
+
+MutationJournal::MutationJournal(QObject* parent)
+    : QObject(parent), m_entryCount(0),
+      m_compactionThreshold(DefaultCompactionThreshold), m_nextCompactionAt(DefaultCompactionThreshold),
+      m_compacting(false), m_generation(0) {}
+
+MutationJournal::~MutationJournal() {
+    close();
+}
+
+bool MutationJournal::open(const QString& filename) {
+    close();
+    qint64 completeBytes = 0;
+    QVector<Entry> entries = readEntries(filename, &completeBytes);
+    int fileGeneration = generationOf(entries);
+    
+    m_file.setFileName(filename);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) return false;
+    
+    // An older journal was already compacted into the files; only its
+    // truncation was lost
+    if (fileGeneration < m_generation) {
+        entries.clear();
+        completeBytes = 0;
+    }
+    
+    // Drop a torn last line so the next entry starts on a fresh one
+    if (m_file.size() > completeBytes && !m_file.resize(completeBytes)) {
+        m_file.close();
+        return false;
+    }
+    m_generation = qMax(m_generation, fileGeneration);
+    if (m_file.size() == 0 && !writeLine({ "G", QString::number(m_generation) })) {
+        m_file.close();
+        return false;
+    }
+    
+    m_entryCount = 0;
+    for (const Entry& entry : entries) {
+        if (entry.operation != Operation::Compaction) m_entryCount++;
+    }
+    m_nextCompactionAt = m_compactionThreshold;
+    return true;
+}
+
+void MutationJournal::close() {
+    if (m_file.isOpen()) m_file.close();
+    m_entryCount = 0;
+}
+
+bool MutationJournal::isOpen() const {
+    return m_file.isOpen();
+}
+
+bool MutationJournal::truncate() {
+    if (!m_file.isOpen()) return false;
+    
+    // The emptied journal replaces the old one in a single rename, so a
+    // failure leaves every entry in place. Windows cannot rename over an
+    // open file, hence the close before the commit
+    QString filename = m_file.fileName();
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    QByteArray marker = QString("G\t%1\n").arg(m_generation).toUtf8();
+    if (file.write(marker) != marker.size()) return false;
+    
+    m_file.close();
+    bool committed = file.commit();
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) return false;
+    if (!committed) return false;
+    m_entryCount = 0;
+    m_nextCompactionAt = m_compactionThreshold;
+    return true;
+}
+
+int MutationJournal::getGeneration() const { return m_generation; }
+void MutationJournal::setGeneration(int generation) { m_generation = generation; }
+
+int MutationJournal::getEntryCount() const { return m_entryCount; }
+int MutationJournal::getCompactionThreshold() const { return m_compactionThreshold; }
+void MutationJournal::setCompactionThreshold(int threshold) {
+    m_compactionThreshold = threshold;
+    m_nextCompactionAt = threshold;
+}
+
+bool MutationJournal::recordStationInserted(int id, const QString& name) {
+    return append({ "S", QString::number(id), escapeField(name) });
+}
+
+bool MutationJournal::recordStationDeleted(int id) {
+    return append({ "D", QString::number(id) });
+}
+
+bool MutationJournal::recordEdgeAdded(int from, int to, double weight) {
+    return append({ "A", QString::number(from), QString::number(to), QString::number(weight, 'g', 17) });
+}
+
+bool MutationJournal::recordEdgeRemoved(int from, int to) {
+    return append({ "R", QString::number(from), QString::number(to) });
+}
+
+bool MutationJournal::recordClosure(int from, int to, bool closed) {
+    return append({ closed ? "C" : "O", QString::number(from), QString::number(to) });
+}
+
+bool MutationJournal::recordReport(const ReportManager::ReportEntry& report) {
+    QStringList fields;
+    fields << "P"
+           << report.timestamp.toString(Qt::ISODateWithMs)
+           << escapeField(report.algorithm)
+           << QString::number(report.originId)
+           << escapeField(report.originName)
+           << QString::number(report.destinationId)
+           << escapeField(report.destinationName)
+           << QString::number(report.totalCost, 'g', 17)
+           << QString::number(report.path.size());
+    for (int i = 0; i < report.path.size(); ++i) {
+        fields << QString::number(report.path[i])
+               << escapeField(i < report.pathNames.size() ? report.pathNames[i] : QString());
+    }
+    if (!report.alternatives.isEmpty()) {
+        fields << QString::number(report.alternatives.size());
+        for (const ReportManager::Alternative& alternative : report.alternatives) {
+            fields << QString::number(alternative.totalCost, 'g', 17)
+                   << QString::number(alternative.path.size());
+            for (int i = 0; i < alternative.path.size(); ++i) {
+                fields << QString::number(alternative.path[i])
+                       << escapeField(i < alternative.pathNames.size() ? alternative.pathNames[i] : QString());
+            }
+        }
+    }
+    return append(fields);
+}
+
+QVector<MutationJournal::Entry> MutationJournal::readEntries(const QString& filename, qint64* completeBytes) {
+    QVector<Entry> entries;
+    if (completeBytes) *completeBytes = 0;
+    MappedFile file(filename);
+    if (!file.open()) return entries;
+    
+    const char* cursor = file.data();
+    const char* end = cursor + file.size();
+    while (cursor < end) {
+        const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        // A line without its terminator was cut short by a crash
+        if (newline == nullptr) break;
+        
+        QString line = QString::fromUtf8(cursor, newline - cursor);
+        cursor = newline + 1;
+        if (completeBytes) *completeBytes = cursor - file.data();
+        
+        Entry entry;
+        if (parseEntry(line.split('\t'), entry)) {
+            entries.append(entry);
+        }
+    }
+    return entries;
+}
+
+int MutationJournal::generationOf(const QVector<Entry>& entries) {
+    // Journals written before compactions were numbered have no marker
+    if (entries.isEmpty() || entries.first().operation != Operation::Compaction) return 0;
+    return entries.first().first;
+}
+
+bool MutationJournal::append(const QStringList& fields) {
+    if (!m_file.isOpen()) return true;
+    
+    qint64 size = m_file.size();
+    if (!writeLine(fields)) {
+        // Cut any partial line so the next entry starts on a fresh one
+        m_file.resize(size);
+        emit errorOccurred(QString("No se pudo escribir en el registro de cambios: %1").arg(m_file.fileName()));
+        return false;
+    }
+    m_entryCount++;
+    
+    if (m_entryCount >= m_nextCompactionAt && !m_compacting) {
+        m_compacting = true;
+        m_nextCompactionAt = m_entryCount + m_compactionThreshold;
+        emit compactionRequested();
+        m_compacting = false;
+    }
+    return true;
+}
+
+bool MutationJournal::writeLine(const QStringList& fields) {
+    QByteArray line = fields.join('\t').toUtf8();
+    line.append('\n');
+    return m_file.write(line) == line.size() && sync();
+}
+
+bool MutationJournal::sync() {
+    if (!m_file.flush()) return false;
+#ifdef Q_OS_WIN
+    return _commit(m_file.handle()) == 0;
+#else
+    return fsync(m_file.handle()) == 0;
+#endif
+}
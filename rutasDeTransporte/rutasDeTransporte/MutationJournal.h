@@ -0,0 +1,92 @@
+#ifndef MUTATIONJOURNAL_H
+#define MUTATIONJOURNAL_H
+
+#include <QObject>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include "ReportManager.h"
+
+/**
+ * @brief Append-only log of every change made since the last full save
+ *
+ * One tab-separated text line per change, flushed to disk before the call
+ * returns. A line cut short by a crash is ignored on replay. Once the log
+ * holds more entries than the compaction threshold it asks for the full
+ * files to be rewritten, after which it is truncated.
+ *
+ * Compactions are numbered. The journal starts with the number of the one
+ * it follows, and reportes.txt carries the number of the one that wrote
+ * it, so a journal whose truncation was lost in a crash can be recognised
+ * as already compacted.
+ */
+class MutationJournal : public QObject {
+    Q_OBJECT
+    
+public:
+    enum class Operation {
+        InsertStation,
+        DeleteStation,
+        AddEdge,
+        RemoveEdge,
+        CloseEdge,
+        ReopenEdge,
+        AppendReport,
+        // First line of every journal: the compaction it follows
+        Compaction
+    };
+    
+    struct Entry {
+        Operation operation;
+        int first;
+        int second;
+        double weight;
+        QString name;
+        ReportManager::ReportEntry report;
+    };
+    
+    explicit MutationJournal(QObject* parent = nullptr);
+    ~MutationJournal();
+    
+    bool open(const QString& filename);
+    void close();
+    bool isOpen() const;
+    bool truncate();
+    int getGeneration() const;
+    void setGeneration(int generation);
+    
+    int getEntryCount() const;
+    int getCompactionThreshold() const;
+    void setCompactionThreshold(int threshold);
+    
+    bool recordStationInserted(int id, const QString& name);
+    bool recordStationDeleted(int id);
+    bool recordEdgeAdded(int from, int to, double weight);
+    bool recordEdgeRemoved(int from, int to);
+    bool recordClosure(int from, int to, bool closed);
+    bool recordReport(const ReportManager::ReportEntry& report);
+    
+    static QVector<Entry> readEntries(const QString& filename, qint64* completeBytes = nullptr);
+    static int generationOf(const QVector<Entry>& entries);
+    
+signals:
+    void compactionRequested();
+    void errorOccurred(const QString& message);
+    
+private:
+    QFile m_file;
+    int m_entryCount;
+    int m_compactionThreshold;
+    // Entry count at which compaction is next requested; pushed back by a
+    // threshold after every request, so a failing compaction is not retried
+    // on every change
+    int m_nextCompactionAt;
+    bool m_compacting;
+    int m_generation;
+    
+    bool append(const QStringList& fields);
+    bool writeLine(const QStringList& fields);
+    bool sync();
+};
+
+#endif // MUTATIONJOURNAL_H
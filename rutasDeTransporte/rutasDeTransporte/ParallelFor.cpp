@@ -0,0 +1,56 @@
+#include "ParallelFor.h"
+#include <QThread>
+#include <QVector>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+int ParallelFor::workerCount() {
+    return qMax(1, QThread::idealThreadCount());
+}
+
+void ParallelFor::run(int taskCount, const std::function<void(int task, int worker)>& body, int maxWorkers) {
+    if (taskCount <= 0) return;
+    
+    int workers = maxWorkers > 0 ? qMin(maxWorkers, workerCount()) : workerCount();
+    workers = qMin(workers, taskCount);
+    
+    if (workers == 1) {
+        for (int task = 0; task < taskCount; ++task) {
+            body(task, 0);
+        }
+        return;
+    }
+    
+    std::atomic<int> nextTask(0);
+    std::atomic<bool> failed(false);
+    QVector<std::exception_ptr> errors(workers);
+    
+    auto work = [&](int worker) {
+        try {
+            int task;
+            while (!failed.load(std::memory_order_relaxed) &&
+                   (task = nextTask.fetch_add(1, std::memory_order_relaxed)) < taskCount) {
+                body(task, worker);
+            }
+        } catch (...) {
+            errors[worker] = std::current_exception();
+            failed.store(true);
+        }
+    };
+    
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (int worker = 1; worker < workers; ++worker) {
+        threads.emplace_back(work, worker);
+    }
+    work(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    
+    for (const std::exception_ptr& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
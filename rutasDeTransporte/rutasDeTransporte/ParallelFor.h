@@ -0,0 +1,20 @@
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <functional>
+
+/**
+ * @brief Minimal fork-join helper for data-parallel loops
+ *
+ * Task indices are handed out through a shared atomic counter, so a worker
+ * that finishes early keeps pulling tasks until none are left. The calling
+ * thread takes part as worker 0. The first exception thrown by a task is
+ * rethrown on the calling thread once every worker has stopped.
+ */
+class ParallelFor {
+public:
+    static int workerCount();
+    static void run(int taskCount, const std::function<void(int task, int worker)>& body, int maxWorkers = 0);
+};
+
+#endif // PARALLELFOR_H
@@ -0,0 +1,49 @@
+#include "RadixHeap.h"
+#include <QtAlgorithms>
+
+RadixHeap::RadixHeap() : m_last(0), m_size(0) {}
+
+void RadixHeap::clear() {
+    for (QVector<Item>& bucket : m_buckets) {
+        bucket.clear();
+    }
+    m_last = 0;
+    m_size = 0;
+}
+
+bool RadixHeap::isEmpty() const { return m_size == 0; }
+
+int RadixHeap::size() const { return m_size; }
+
+void RadixHeap::push(int index, quint64 key) {
+    m_buckets[bucketOf(key)].append(Item{key, index});
+    m_size++;
+}
+
+int RadixHeap::popMin() {
+    if (m_buckets[0].isEmpty()) {
+        int source = 1;
+        while (m_buckets[source].isEmpty()) ++source;
+        
+        // The smallest key of the first non-empty bucket becomes the new
+        // reference, which sends each of its items to a strictly lower bucket
+        QVector<Item>& bucket = m_buckets[source];
+        m_last = bucket[0].key;
+        for (const Item& item : bucket) {
+            m_last = qMin(m_last, item.key);
+        }
+        for (const Item& item : bucket) {
+            m_buckets[bucketOf(item.key)].append(item);
+        }
+        bucket.clear();
+    }
+    
+    m_size--;
+    return m_buckets[0].takeLast().index;
+}
+
+quint64 RadixHeap::lastKey() const { return m_last; }
+
+int RadixHeap::bucketOf(quint64 key) const {
+    return key == m_last ? 0 : 64 - int(qCountLeadingZeroBits(key ^ m_last));
+}
@@ -0,0 +1,45 @@
+#ifndef RADIXHEAP_H
+#define RADIXHEAP_H
+
+#include <QVector>
+#include <QtGlobal>
+
+/**
+ * @brief Monotone integer priority queue (radix heap) over dense indices
+ *
+ * Keys must never be smaller than the last key popped, which holds for
+ * Dijkstra with non-negative integer weights. An item lives in the bucket
+ * named by the highest bit in which its key differs from the last popped
+ * key; popping from an empty bottom bucket redistributes the next bucket
+ * downwards, so every item moves at most once per bit.
+ *
+ * There is no decrease-key: a station whose distance drops is pushed again
+ * and the caller skips entries whose key no longer matches its distance.
+ */
+class RadixHeap {
+public:
+    RadixHeap();
+    
+    void clear();
+    bool isEmpty() const;
+    int size() const;
+    
+    void push(int index, quint64 key);
+    int popMin();
+    quint64 lastKey() const;
+    
+private:
+    struct Item {
+        quint64 key;
+        int index;
+    };
+    
+    static const int BucketCount = 65;
+    QVector<Item> m_buckets[BucketCount];
+    quint64 m_last;
+    int m_size;
+    
+    int bucketOf(quint64 key) const;
+};
+
+#endif // RADIXHEAP_H
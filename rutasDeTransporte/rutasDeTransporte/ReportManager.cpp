@@ -1,30 +1,47 @@
 #include "ReportManager.h"
 #include <QFile>
+#include <QSaveFile>
 #include <QTextStream>
 #include <QStringConverter>
 
-ReportManager::ReportManager() {}
+namespace {
+
+// First line of reportes.txt, followed by the compaction number
+const char* const GenerationPrefix = "# Compactación: ";
+
+}
+
+ReportManager::ReportManager() : m_generation(0) {}
 
 void ReportManager::addReport(const ReportEntry& entry) {
     m_reports.append(entry);
 }
 
 bool ReportManager::loadReports(const QString& filename) {
+    m_generation = 0;
     QFile file(filename);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+    
+    QTextStream in(&file);
+    in.setEncoding(QStringConverter::Utf8);
+    QString header = in.readLine();
+    if (header.startsWith(GenerationPrefix)) {
+        m_generation = header.mid(QString(GenerationPrefix).size()).toInt();
+    }
     file.close();
     return true;
 }
 
 bool ReportManager::saveReports(const QString& filename) const {
-    QFile file(filename);
+    QSaveFile file(filename);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
     
     QTextStream out(&file);
     out.setEncoding(QStringConverter::Utf8);
+    out << GenerationPrefix << m_generation << "\n";
     out << getReportsAsText();
-    file.close();
-    return true;
+    out.flush();
+    return file.commit();
 }
 
 QString ReportManager::getReportsAsText() const {
@@ -76,6 +93,20 @@ QString ReportManager::getReportsAsText() const {
                 }
                 result += "\n";
                 result += QString("Costo Total: %1 km\n").arg(report.totalCost, 0, 'f', 2);
+                
+                for (int a = 0; a < report.alternatives.size(); ++a) {
+                    const Alternative& alternative = report.alternatives[a];
+                    result += QString("Ruta alternativa #%1: ").arg(a + 2);
+                    for (int j = 0; j < alternative.path.size(); ++j) {
+                        result += QString::number(alternative.path[j]);
+                        if (j < alternative.pathNames.size() && !alternative.pathNames[j].isEmpty()) {
+                            result += QString(" (%1)").arg(alternative.pathNames[j]);
+                        }
+                        if (j < alternative.path.size() - 1) result += " → ";
+                    }
+                    result += "\n";
+                    result += QString("Costo: %1 km\n").arg(alternative.totalCost, 0, 'f', 2);
+                }
             }
         }
         
@@ -91,3 +122,6 @@ void ReportManager::clear() {
 int ReportManager::getReportCount() const {
     return m_reports.size();
 }
+
+int ReportManager::getGeneration() const { return m_generation; }
+void ReportManager::setGeneration(int generation) { m_generation = generation; }
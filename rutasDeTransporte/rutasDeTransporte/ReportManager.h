@@ -7,6 +7,13 @@
 
 class ReportManager {
 public:
+    // Further routes of a query that returns several, cheapest first
+    struct Alternative {
+        QVector<int> path;
+        QVector<QString> pathNames;
+        double totalCost;
+    };
+    
     struct ReportEntry {
         QDateTime timestamp;
         QString algorithm;
@@ -17,6 +24,7 @@ public:
         QVector<int> path;
         QVector<QString> pathNames;
         double totalCost;
+        QVector<Alternative> alternatives;
     };
     
     ReportManager();
@@ -28,8 +36,13 @@ public:
     void clear();
     int getReportCount() const;
     
+    // Number of the compaction that last wrote the reports file
+    int getGeneration() const;
+    void setGeneration(int generation);
+    
 private:
     QVector<ReportEntry> m_reports;
+    int m_generation;
 };
 
 #endif // REPORTMANAGER_H
@@ -0,0 +1,69 @@
+#include "SearchWorkspace.h"
+#include "GraphSnapshot.h"
+#include <algorithm>
+#include <limits>
+
+SearchWorkspace::SearchWorkspace() : m_generation(0) {}
+
+void SearchWorkspace::prepare(int nodeCount) {
+    if (m_entries.size() != nodeCount) {
+        m_entries.fill(Entry{0.0, -1, 0}, nodeCount);
+        m_heap.reset(nodeCount);
+        m_frontier.reserve(nodeCount);
+        m_generation = 0;
+    }
+    
+    // Generations advance by two; stamps only need wiping when they run out
+    m_generation += 2;
+    if (m_generation > std::numeric_limits<quint32>::max() - 2) {
+        for (Entry& entry : m_entries) {
+            entry.stamp = 0;
+        }
+        m_generation = 2;
+    }
+    m_heap.clear();
+    m_radixHeap.clear();
+    m_frontier.clear();
+}
+
+bool SearchWorkspace::isReached(int node) const {
+    return m_entries[node].stamp - m_generation < 2;
+}
+
+double SearchWorkspace::distance(int node) const {
+    return isReached(node) ? m_entries[node].distance : std::numeric_limits<double>::infinity();
+}
+
+int SearchWorkspace::parent(int node) const {
+    return isReached(node) ? m_entries[node].parent : -1;
+}
+
+void SearchWorkspace::setLabel(int node, double distance, int parent) {
+    Entry& entry = m_entries[node];
+    entry.distance = distance;
+    entry.parent = parent;
+    // Older generations are always smaller, so a visited mark survives
+    entry.stamp = qMax(entry.stamp, m_generation);
+}
+
+bool SearchWorkspace::isVisited(int node) const {
+    return m_entries[node].stamp == m_generation + 1;
+}
+
+void SearchWorkspace::markVisited(int node) {
+    m_entries[node].stamp = m_generation + 1;
+}
+
+IndexedMinHeap& SearchWorkspace::heap() { return m_heap; }
+
+RadixHeap& SearchWorkspace::radixHeap() { return m_radixHeap; }
+
+QVector<int>& SearchWorkspace::frontier() { return m_frontier; }
+
+void SearchWorkspace::tracePath(const GraphSnapshot& snapshot, int node, QVector<int>& path) const {
+    int begin = path.size();
+    for (; node != -1; node = parent(node)) {
+        path.append(snapshot.stationIdAt(node));
+    }
+    std::reverse(path.begin() + begin, path.end());
+}
@@ -0,0 +1,60 @@
+#ifndef SEARCHWORKSPACE_H
+#define SEARCHWORKSPACE_H
+
+#include "IndexedMinHeap.h"
+#include "RadixHeap.h"
+#include <QVector>
+#include <QtGlobal>
+
+class GraphSnapshot;
+
+/**
+ * @brief Reusable per-thread scratch space for single-source searches
+ *
+ * Distance, parent and visited state live in dense arrays sized to the
+ * snapshot. Instead of clearing them, every search starts a new generation:
+ * an entry only counts when its stamp belongs to the current generation,
+ * so prepare() leaves the arrays alone once they have the right size.
+ *
+ * A node is "reached" once it has a label and "visited" once the search is
+ * done with it; only reached nodes can be marked visited. Both states share
+ * one stamp (generation for reached, generation + 1 for visited), kept next
+ * to the label so a relaxation touches a single record.
+ *
+ * Each workspace must only be used by one thread at a time.
+ */
+class SearchWorkspace {
+public:
+    SearchWorkspace();
+    
+    void prepare(int nodeCount);
+    
+    bool isReached(int node) const;
+    double distance(int node) const;
+    int parent(int node) const;
+    void setLabel(int node, double distance, int parent);
+    
+    bool isVisited(int node) const;
+    void markVisited(int node);
+    
+    IndexedMinHeap& heap();
+    RadixHeap& radixHeap();
+    QVector<int>& frontier();
+    
+    void tracePath(const GraphSnapshot& snapshot, int node, QVector<int>& path) const;
+    
+private:
+    struct Entry {
+        double distance;
+        int parent;
+        quint32 stamp;
+    };
+    
+    QVector<Entry> m_entries;
+    quint32 m_generation;
+    IndexedMinHeap m_heap;
+    RadixHeap m_radixHeap;
+    QVector<int> m_frontier;
+};
+
+#endif // SEARCHWORKSPACE_H
@@ -1,8 +1,12 @@
 #include "Station.h"
 
-Station::Station() : m_id(0), m_name("") {}
+Station::Station() : m_id(0), m_name(""), m_x(0.0), m_y(0.0), m_hasCoordinates(false) {}
 
-Station::Station(int id, const QString& name) : m_id(id), m_name(name) {}
+Station::Station(int id, const QString& name) 
+    : m_id(id), m_name(name), m_x(0.0), m_y(0.0), m_hasCoordinates(false) {}
+
+Station::Station(int id, const QString& name, double x, double y) 
+    : m_id(id), m_name(name), m_x(x), m_y(y), m_hasCoordinates(true) {}
 
 int Station::getId() const { return m_id; }
 
@@ -12,6 +16,24 @@ void Station::setId(int id) { m_id = id; }
 
 void Station::setName(const QString& name) { m_name = name; }
 
+bool Station::hasCoordinates() const { return m_hasCoordinates; }
+
+double Station::getX() const { return m_x; }
+
+double Station::getY() const { return m_y; }
+
+void Station::setCoordinates(double x, double y) {
+    m_x = x;
+    m_y = y;
+    m_hasCoordinates = true;
+}
+
+void Station::clearCoordinates() {
+    m_x = 0.0;
+    m_y = 0.0;
+    m_hasCoordinates = false;
+}
+
 bool Station::operator<(const Station& other) const {
     return m_id < other.m_id;
 }
@@ -8,12 +8,19 @@ class Station {
 public:
     Station();
     Station(int id, const QString& name);
+    Station(int id, const QString& name, double x, double y);
     
     int getId() const;
     QString getName() const;
     void setId(int id);
     void setName(const QString& name);
     
+    bool hasCoordinates() const;
+    double getX() const;
+    double getY() const;
+    void setCoordinates(double x, double y);
+    void clearCoordinates();
+    
     bool operator<(const Station& other) const;
     bool operator>(const Station& other) const;
     bool operator==(const Station& other) const;
@@ -21,6 +28,9 @@ public:
 private:
     int m_id;
     QString m_name;
+    double m_x;
+    double m_y;
+    bool m_hasCoordinates;
 };
 
 Q_DECLARE_METATYPE(Station)
@@ -1,7 +1,9 @@
 #include "TreeController.h"
+#include "Graph.h"
+#include "MutationJournal.h"
 
 TreeController::TreeController(BinarySearchTree* tree, ReportManager* reportManager, QObject* parent) 
-    : QObject(parent), m_tree(tree), m_reportManager(reportManager) {
+    : QObject(parent), m_tree(tree), m_reportManager(reportManager), m_graph(nullptr), m_journal(nullptr) {
 }
 
 TreeController::~TreeController() {
@@ -15,6 +17,14 @@ QVector<Station> TreeController::getAllStations() const {
     return m_tree->getAllStations();
 }
 
+void TreeController::setGraph(Graph* graph) {
+    m_graph = graph;
+}
+
+void TreeController::setJournal(MutationJournal* journal) {
+    m_journal = journal;
+}
+
 void TreeController::insertStation(int id, const QString& name) {
     try {
         Station station(id, name);
@@ -25,6 +35,9 @@ void TreeController::insertStation(int id, const QString& name) {
             return;
         }
         m_tree->insert(station);
+        if (m_journal && !m_journal->recordStationInserted(id, name)) {
+            emit errorOccurred("El cambio no quedó guardado en el registro de cambios");
+        }
         emit stationInserted(id, name, true);
     } catch (...) {
         emit stationInserted(id, name, false);
@@ -35,6 +48,10 @@ void TreeController::insertStation(int id, const QString& name) {
 void TreeController::deleteStation(int id) {
     try {
         bool success = m_tree->remove(id);
+        if (success && m_graph) m_graph->removeStation(id);
+        if (success && m_journal && !m_journal->recordStationDeleted(id)) {
+            emit errorOccurred("El cambio no quedó guardado en el registro de cambios");
+        }
         emit stationDeleted(id, success);
         if (!success) {
             emit errorOccurred(QString("No se encontró la estación con ID %1").arg(id));
@@ -6,6 +6,9 @@
 #include "Station.h"
 #include "ReportManager.h"
 
+class Graph;
+class MutationJournal;
+
 class TreeController : public QObject {
     Q_OBJECT
     
@@ -15,6 +18,8 @@ public:
     
     BinarySearchTree* getTree();
     QVector<Station> getAllStations() const;
+    void setGraph(Graph* graph);
+    void setJournal(MutationJournal* journal);
     
 public slots:
     void insertStation(int id, const QString& name);
@@ -38,6 +43,8 @@ signals:
 private:
     BinarySearchTree* m_tree;
     ReportManager* m_reportManager;
+    Graph* m_graph;
+    MutationJournal* m_journal;
 };
 
 #endif // TREECONTROLLER_H
@@ -1,6 +1,6 @@
 #include "TreeNode.h"
 
 TreeNode::TreeNode(const Station& station) 
-    : data(station), left(nullptr), right(nullptr) {}
+    : data(station), left(nullptr), right(nullptr), height(1) {}
 
 TreeNode::~TreeNode() {}
@@ -8,6 +8,7 @@ public:
     Station data;
     TreeNode* left;
     TreeNode* right;
+    int height;
     
     TreeNode(const Station& station);
     ~TreeNode();
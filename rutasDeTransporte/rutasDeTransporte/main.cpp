@@ -2,6 +2,7 @@
 #include "TreeController.h"
 #include "GraphController.h"
 #include "FileController.h"
+#include "MutationJournal.h"
 #include "BinarySearch.h"
 #include "Graph.h"
 #include "ReportManager.h"
@@ -17,6 +18,8 @@ int main(int argc, char *argv[]) {
     qRegisterMetaType<QVector<Station>>("QVector<Station>");
     qRegisterMetaType<QVector<Edge>>("QVector<Edge>");
     qRegisterMetaType<QVector<int>>("QVector<int>");
+    qRegisterMetaType<QVector<double>>("QVector<double>");
+    qRegisterMetaType<QVector<QVector<int>>>("QVector<QVector<int>>");
     qRegisterMetaType<QPair<int,int>>("QPair<int,int>");
     qRegisterMetaType<QVector<QPair<int,int>>>("QVector<QPair<int,int>>");
     
@@ -32,6 +35,13 @@ int main(int argc, char *argv[]) {
     fileController->setReportManager(reportManager);
     fileController->setDataPath("data/");
     
+    MutationJournal* journal = new MutationJournal();
+    fileController->setJournal(journal);
+    treeController->setGraph(graph);
+    treeController->setJournal(journal);
+    graphController->setJournal(journal);
+    graphController->setCachePath("data/red.ch");
+    
     MainWindow mainWindow(treeController, graphController, fileController);
     
     fileController->loadAll();
@@ -46,6 +56,7 @@ int main(int argc, char *argv[]) {
     delete treeController;
     delete graphController;
     delete fileController;
+    delete journal;
     delete bst;
     delete graph;
     delete reportManager;
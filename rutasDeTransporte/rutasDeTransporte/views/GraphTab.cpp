@@ -30,8 +30,11 @@ GraphTab::GraphTab(GraphController* controller, QWidget* parent)
     
     connect(m_controller, &GraphController::mapLoaded, this, &GraphTab::onMapLoaded);
     connect(m_controller, &GraphController::pathFound, this, &GraphTab::onPathFound);
+    connect(m_controller, &GraphController::kPathsFound, this, &GraphTab::onKPathsFound);
     connect(m_controller, &GraphController::pathNotFound, this, &GraphTab::onPathNotFound);
     connect(m_controller, &GraphController::errorOccurred, this, &GraphTab::onError);
+    connect(m_controller, &GraphController::hubLabelsBuilt, this, &GraphTab::onHubLabelsBuilt);
+    connect(m_controller, &GraphController::hubRegistered, this, &GraphTab::onHubRegistered);
 }
 
 void GraphTab::setupUI() {
@@ -43,29 +46,45 @@ void GraphTab::setupUI() {
     m_removeEdgeButton = new QPushButton("Eliminar Conexión", this);
     m_markClosureButton = new QPushButton("Marcar Accidente", this);
     m_reopenEdgeButton = new QPushButton("Reabrir Ruta", this);
+    m_registerHubButton = new QPushButton("Estación Central", this);
     buttonLayout1->addWidget(m_loadMapButton);
     buttonLayout1->addWidget(m_addEdgeButton);
     buttonLayout1->addWidget(m_removeEdgeButton);
     buttonLayout1->addWidget(m_markClosureButton);
     buttonLayout1->addWidget(m_reopenEdgeButton);
+    buttonLayout1->addWidget(m_registerHubButton);
     mainLayout->addLayout(buttonLayout1);
     
     QHBoxLayout* buttonLayout2 = new QHBoxLayout();
     m_bfsButton = new QPushButton("BFS", this);
     m_dfsButton = new QPushButton("DFS", this);
     m_dijkstraButton = new QPushButton("Dijkstra", this);
+    m_integerDijkstraButton = new QPushButton("Dijkstra (metros)", this);
+    m_aStarButton = new QPushButton("A*", this);
+    m_bidirectionalButton = new QPushButton("Dijkstra Bidireccional", this);
+    m_hierarchyButton = new QPushButton("Jerarquías (CH)", this);
+    m_landmarkButton = new QPushButton("A* Landmarks (ALT)", this);
+    m_hubLabelsButton = new QPushButton("Etiquetas (HL)", this);
     m_floydButton = new QPushButton("Floyd-Warshall", this);
     buttonLayout2->addWidget(m_bfsButton);
     buttonLayout2->addWidget(m_dfsButton);
     buttonLayout2->addWidget(m_dijkstraButton);
+    buttonLayout2->addWidget(m_integerDijkstraButton);
+    buttonLayout2->addWidget(m_aStarButton);
+    buttonLayout2->addWidget(m_bidirectionalButton);
+    buttonLayout2->addWidget(m_hierarchyButton);
+    buttonLayout2->addWidget(m_landmarkButton);
+    buttonLayout2->addWidget(m_hubLabelsButton);
     buttonLayout2->addWidget(m_floydButton);
     mainLayout->addLayout(buttonLayout2);
     
     QHBoxLayout* buttonLayout3 = new QHBoxLayout();
     buttonLayout3->addStretch();
+    m_kShortestButton = new QPushButton("Rutas Alternativas", this);
     m_kruskalButton = new QPushButton("Kruskal", this);
     m_primButton = new QPushButton("Prim", this);
     m_reportButton = new QPushButton("Generar Reporte", this);
+    buttonLayout3->addWidget(m_kShortestButton);
     buttonLayout3->addWidget(m_kruskalButton);
     buttonLayout3->addWidget(m_primButton);
     buttonLayout3->addWidget(m_reportButton);
@@ -102,10 +121,18 @@ void GraphTab::setupUI() {
     connect(m_removeEdgeButton, &QPushButton::clicked, this, &GraphTab::onRemoveEdgeClicked);
     connect(m_markClosureButton, &QPushButton::clicked, this, &GraphTab::onMarkClosureClicked);
     connect(m_reopenEdgeButton, &QPushButton::clicked, this, &GraphTab::onReopenEdgeClicked);
+    connect(m_registerHubButton, &QPushButton::clicked, this, &GraphTab::onRegisterHubClicked);
     connect(m_bfsButton, &QPushButton::clicked, this, &GraphTab::onBFSClicked);
     connect(m_dfsButton, &QPushButton::clicked, this, &GraphTab::onDFSClicked);
     connect(m_dijkstraButton, &QPushButton::clicked, this, &GraphTab::onDijkstraClicked);
+    connect(m_integerDijkstraButton, &QPushButton::clicked, this, &GraphTab::onIntegerDijkstraClicked);
+    connect(m_aStarButton, &QPushButton::clicked, this, &GraphTab::onAStarClicked);
+    connect(m_bidirectionalButton, &QPushButton::clicked, this, &GraphTab::onBidirectionalClicked);
+    connect(m_hierarchyButton, &QPushButton::clicked, this, &GraphTab::onContractionHierarchyClicked);
+    connect(m_landmarkButton, &QPushButton::clicked, this, &GraphTab::onLandmarkClicked);
+    connect(m_hubLabelsButton, &QPushButton::clicked, this, &GraphTab::onHubLabelsClicked);
     connect(m_floydButton, &QPushButton::clicked, this, &GraphTab::onFloydWarshallClicked);
+    connect(m_kShortestButton, &QPushButton::clicked, this, &GraphTab::onKShortestClicked);
     connect(m_kruskalButton, &QPushButton::clicked, this, &GraphTab::onKruskalClicked);
     connect(m_primButton, &QPushButton::clicked, this, &GraphTab::onPrimClicked);
     connect(m_reportButton, &QPushButton::clicked, this, &GraphTab::onGenerateReportClicked);
@@ -261,14 +288,7 @@ void GraphTab::drawPath(const QVector<int>& path) {
         QPointF fromCenter = fromNode->rect().center() + fromNode->pos();
         QPointF toCenter = toNode->rect().center() + toNode->pos();
         
-        bool isClosed = false;
-        for (const Edge& edge : m_edges) {
-            if ((edge.getFrom() == fromId && edge.getTo() == toId) ||
-                (edge.getFrom() == toId && edge.getTo() == fromId)) {
-                isClosed = edge.isClosed();
-                break;
-            }
-        }
+        bool isClosed = m_controller->getGraph()->isEdgeClosed(fromId, toId);
         
         QPen pathPen;
         if (isClosed) {
@@ -361,11 +381,19 @@ void GraphTab::onReopenEdgeClicked() {
     int toId = QInputDialog::getInt(this, "Reabrir Ruta", "ID estación destino:", 0, 0, 99999, 1, &ok);
     if (!ok) return;
     
-    m_controller->getGraph()->markEdgeClosed(fromId, toId, false, true);
+    m_controller->reopenEdge(fromId, toId);
     m_controller->loadMap();
     appendOutput(QString("✓ Ruta reabierta entre estaciones %1 y %2").arg(fromId).arg(toId));
 }
 
+void GraphTab::onRegisterHubClicked() {
+    bool ok;
+    int stationId = QInputDialog::getInt(this, "Estación Central", "ID estación:", 0, 0, 99999, 1, &ok);
+    if (!ok) return;
+    
+    m_controller->registerHub(stationId);
+}
+
 void GraphTab::onBFSClicked() {
     bool ok;
     int startId = QInputDialog::getInt(this, "BFS", "ID estación inicial:", 0, 0, 99999, 1, &ok);
@@ -396,6 +424,78 @@ void GraphTab::onDijkstraClicked() {
     m_controller->runDijkstra(startId, endId);
 }
 
+void GraphTab::onIntegerDijkstraClicked() {
+    bool ok;
+    int startId = QInputDialog::getInt(this, "Dijkstra (metros)", "ID estación inicial:", 0, 0, 99999, 1, &ok);
+    if (!ok) return;
+    int endId = QInputDialog::getInt(this, "Dijkstra (metros)", "ID estación final:", 0, 0, 99999, 1, &ok);
+    if (!ok) return;
+    
+    m_controller->runIntegerDijkstra(startId, endId);
+}
+
+void GraphTab::onKShortestClicked() {
+    bool ok;
+    int startId = QInputDialog::getInt(this, "Rutas Alternativas", "ID estación inicial:", 0, 0, 99999, 1, &ok);
+    if (!ok) return;
+    int endId = QInputDialog::getInt(this, "Rutas Alternativas", "ID estación final:", 0, 0, 99999, 1, &ok);
+    if (!ok) return;
+    int k = QInputDialog::getInt(this, "Rutas Alternativas", "Número de rutas:", 3, 1, 10, 1, &ok);
+    if (!ok) return;
+    
+    m_controller->runKShortest(startId, endId, k);
+}
+
+void GraphTab::onAStarClicked() {
+    bool ok;
+    int startId = QInputDialog::getInt(this, "A*", "ID estación inicial:", 0, 0, 99999, 1, &ok);
+    if (!ok) return;
+    int endId = QInputDialog::getInt(this, "A*", "ID estación final:", 0, 0, 99999, 1, &ok);
+    if (!ok) return;
+    
+    m_controller->runAStar(startId, endId);
+}
+
+void GraphTab::onBidirectionalClicked() {
+    bool ok;
+    int startId = QInputDialog::getInt(this, "Dijkstra Bidireccional", "ID estación inicial:", 0, 0, 99999, 1, &ok);
+    if (!ok) return;
+    int endId = QInputDialog::getInt(this, "Dijkstra Bidireccional", "ID estación final:", 0, 0, 99999, 1, &ok);
+    if (!ok) return;
+    
+    m_controller->runBidirectionalDijkstra(startId, endId);
+}
+
+void GraphTab::onContractionHierarchyClicked() {
+    bool ok;
+    int startId = QInputDialog::getInt(this, "Jerarquías de Contracción", "ID estación inicial:", 0, 0, 99999, 1, &ok);
+    if (!ok) return;
+    int endId = QInputDialog::getInt(this, "Jerarquías de Contracción", "ID estación final:", 0, 0, 99999, 1, &ok);
+    if (!ok) return;
+    
+    m_controller->runContractionHierarchy(startId, endId);
+}
+
+void GraphTab::onLandmarkClicked() {
+    bool ok;
+    int startId = QInputDialog::getInt(this, "A* Landmarks", "ID estación inicial:", 0, 0, 99999, 1, &ok);
+    if (!ok) return;
+    int endId = QInputDialog::getInt(this, "A* Landmarks", "ID estación final:", 0, 0, 99999, 1, &ok);
+    if (!ok) return;
+    
+    m_controller->runLandmarkAStar(startId, endId);
+}
+
+void GraphTab::onHubLabelsClicked() {
+    bool ok;
+    int startId = QInputDialog::getInt(this, "Etiquetas de Hubs", "ID estación inicial:", 0, 0, 99999, 1, &ok);
+    if (!ok) return;
+    int endId = QInputDialog::getInt(this, "Etiquetas de Hubs", "ID estación final:", 0, 0, 99999, 1, &ok);
+    if (!ok) return;
+    
+    m_controller->runHubLabels(startId, endId);
+}
+
 void GraphTab::onFloydWarshallClicked() {
     bool ok;
     int startId = QInputDialog::getInt(this, "Floyd-Warshall", "ID estación inicial:", 0, 0, 99999, 1, &ok);
@@ -440,6 +540,19 @@ void GraphTab::onPathFound(const QString& algorithm, const QVector<int>& path, d
     drawPath(path);
 }
 
+void GraphTab::onKPathsFound(const QVector<QVector<int>>& paths, const QVector<double>& costs) {
+    for (int i = 0; i < paths.size(); ++i) {
+        QString pathStr;
+        for (int j = 0; j < paths[i].size(); ++j) {
+            pathStr += QString::number(paths[i][j]);
+            if (j < paths[i].size() - 1) pathStr += " → ";
+        }
+        appendOutput(QString("✓ Ruta %1/%2: %3 (distancia: %4 km)")
+                     .arg(i + 1).arg(paths.size()).arg(pathStr).arg(costs[i], 0, 'f', 2));
+    }
+    drawPath(paths.first());
+}
+
 void GraphTab::onPathNotFound(const QString& algorithm) {
     appendOutput(QString("✗ %1: No se encontró ruta").arg(algorithm));
 }
@@ -448,6 +561,20 @@ void GraphTab::onError(const QString& message) {
     appendOutput(QString("ERROR: %1").arg(message));
 }
 
+void GraphTab::onHubLabelsBuilt(int stations, double averageLabelSize, qint64 memoryBytes) {
+    appendOutput(QString("Etiquetas de hubs: %1 estaciones, %2 entradas por etiqueta, %3 MB")
+                 .arg(stations).arg(averageLabelSize, 0, 'f', 1)
+                 .arg(memoryBytes / (1024.0 * 1024.0), 0, 'f', 1));
+}
+
+void GraphTab::onHubRegistered(int stationId, bool success) {
+    if (success) {
+        appendOutput(QString("✓ Estación central %1: Dijkstra desde ella se mantiene ante cierres").arg(stationId));
+    } else {
+        appendOutput(QString("✗ La estación %1 no existe").arg(stationId));
+    }
+}
+
 void GraphTab::updateEdgePositions() {
     int edgeIndex = 0;
     
@@ -30,9 +30,17 @@ public slots:
     void onRemoveEdgeClicked();
     void onMarkClosureClicked();
     void onReopenEdgeClicked();
+    void onRegisterHubClicked();
     void onBFSClicked();
     void onDFSClicked();
     void onDijkstraClicked();
+    void onIntegerDijkstraClicked();
+    void onKShortestClicked();
+    void onAStarClicked();
+    void onBidirectionalClicked();
+    void onContractionHierarchyClicked();
+    void onLandmarkClicked();
+    void onHubLabelsClicked();
     void onFloydWarshallClicked();
     void onKruskalClicked();
     void onPrimClicked();
@@ -40,8 +48,11 @@ public slots:
     
     void onMapLoaded(const QVector<Station>& stations, const QVector<Edge>& edges);
     void onPathFound(const QString& algorithm, const QVector<int>& path, double distance);
+    void onKPathsFound(const QVector<QVector<int>>& paths, const QVector<double>& costs);
     void onPathNotFound(const QString& algorithm);
     void onError(const QString& message);
+    void onHubLabelsBuilt(int stations, double averageLabelSize, qint64 memoryBytes);
+    void onHubRegistered(int stationId, bool success);
     void updateEdgePositions();
     
 private:
@@ -58,10 +69,18 @@ private:
     QPushButton* m_removeEdgeButton;
     QPushButton* m_markClosureButton;
     QPushButton* m_reopenEdgeButton;
+    QPushButton* m_registerHubButton;
     QPushButton* m_bfsButton;
     QPushButton* m_dfsButton;
     QPushButton* m_dijkstraButton;
+    QPushButton* m_integerDijkstraButton;
+    QPushButton* m_aStarButton;
+    QPushButton* m_bidirectionalButton;
+    QPushButton* m_hierarchyButton;
+    QPushButton* m_landmarkButton;
+    QPushButton* m_hubLabelsButton;
     QPushButton* m_floydButton;
+    QPushButton* m_kShortestButton;
     QPushButton* m_kruskalButton;
     QPushButton* m_primButton;
     QPushButton* m_reportButton;
@@ -135,13 +135,14 @@ void TreeTab::onInsertClicked() {
         return;
     }
     
-    // Insert station in tree and graph
+    // Insert station in graph and tree; the graph goes first so a journal
+    // compaction triggered by the insert sees both
+    if (m_graphController) {
+        m_graphController->getGraph()->addStation(Station(id, name));
+    }
     m_controller->insertStation(id, name);
     
     if (m_graphController) {
-        Station station(id, name);
-        m_graphController->getGraph()->addStation(station);
-        
         // Ask if user wants to add connections
         QMessageBox msgBox(this);
         msgBox.setWindowTitle("Agregar Conexiones");
@@ -256,28 +257,10 @@ void TreeTab::onDeleteClicked() {
                 appendOutput(QString("✗ Eliminación cancelada para estación ID=%1").arg(id));
                 return;
             }
-            
-            // Delete all edges connected to this station
-            for (const Edge& edge : edges) {
-                m_graphController->removeEdge(id, edge.getTo());
-            }
-            
-            // Also check for edges coming TO this station
-            QVector<Station> allStations = m_controller->getAllStations();
-            for (const Station& station : allStations) {
-                if (station.getId() != id) {
-                    QVector<Edge> incomingEdges = m_graphController->getGraph()->getEdgesFrom(station.getId());
-                    for (const Edge& edge : incomingEdges) {
-                        if (edge.getTo() == id) {
-                            m_graphController->removeEdge(station.getId(), id);
-                        }
-                    }
-                }
-            }
         }
     }
     
-    // Delete from tree
+    // Delete from tree and graph, together with every connection
     m_controller->deleteStation(id);
     
     // Reload map if graph controller exists